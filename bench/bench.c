@@ -0,0 +1,660 @@
+#define _POSIX_C_SOURCE 200809L
+
+/**
+ * bench.c - Micro and macro benchmarks for the headless library
+ *
+ * Times the hot paths of libntris (collision, line clears, ghost/landing
+ * row, rotation kicks) and whole headless games per second, single-game,
+ * through the batch engine and as versus matches. Every result is one
+ * line of key=value pairs on stdout, so runs can be collected and
+ * compared by scripts:
+ *
+ *   bench=<name> iterations=<n> ns_per_op=<t> ops_per_sec=<r>
+ *
+ * Before timing, board_check_collision, board_clear_lines and
+ * game_get_ghost_y are checked against their one-cell-at-a-time
+ * reference implementations (the *_scalar functions) on random boards
+ * and in random and greedy games, comparing every result and the whole
+ * Board after each lock. Any difference stops the suite with a failing
+ * exit status; otherwise each function reports its speed over the
+ * reference:
+ *
+ *   check=<name> cases=<n> ref_ns_per_op=<t> ns_per_op=<t> speedup=<x>
+ *
+ * A corpus written from greedy games (across a reopen after a torn
+ * record) is also mapped back and compared with the locks it recorded.
+ *
+ * Inputs come from a fixed-seed Rng, so every run measures the same work.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ntris.h"
+
+#define BENCH_SEED 0x62656E6368ULL
+#define NUM_BOARDS 256          /* Random boards cycled through per bench */
+#define NUM_POSITIONS 1024      /* Random piece positions per bench */
+#define MAX_GAMES 16384         /* Games played by one games/s bench */
+#define RANDOM_STEP_LIMIT 100000  /* Policy steps per random game */
+#define GREEDY_STEP_LIMIT 500     /* Pieces per greedy game (it rarely dies) */
+#define MATCH_FRAME_LIMIT 36000   /* Frames per greedy match (10 minutes) */
+#define CHECK_GAMES 256           /* Games played against the references */
+#define CHECK_STEP_LIMIT 20000    /* Frames per checked game */
+#define CORPUS_GAMES 4            /* Greedy games written to the corpus check */
+#define CORPUS_PIECES 200         /* Pieces per corpus game */
+
+/* Accumulates results so the compiler cannot drop the timed work */
+static volatile long bench_sink;
+
+/* Random piece position, possibly out of bounds */
+typedef struct {
+    PieceType type;
+    RotationState rotation;
+    int x;
+    int y;
+} BenchPosition;
+
+static Board boards[NUM_BOARDS];
+static BenchPosition positions[NUM_POSITIONS];
+
+/* Get monotonic time in seconds */
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Print one result line */
+static void report(const char* name, long iterations, double seconds) {
+    printf("bench=%s iterations=%ld ns_per_op=%.2f ops_per_sec=%.0f\n",
+           name, iterations, seconds * 1e9 / (double)iterations,
+           (double)iterations / seconds);
+    fflush(stdout);
+}
+
+/* Fill the lower part of a board with random garbage (no full rows) */
+static void random_board(Board* board, Rng* rng) {
+    board_row_t rows[BOARD_HEIGHT];
+    int top = 4 + (int)rng_range(rng, BOARD_HEIGHT - 4);
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        rows[y] = 0;
+        if (y >= top) {
+            rows[y] = (board_row_t)(rng_next(rng) & BOARD_FULL_ROW);
+            rows[y] &= (board_row_t)~(1u << rng_range(rng, BOARD_WIDTH));
+        }
+    }
+    board_load_rows(board, rows);
+}
+
+/* Build the shared random inputs */
+static void setup_inputs(void) {
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+
+    for (int i = 0; i < NUM_BOARDS; i++) {
+        random_board(&boards[i], &rng);
+    }
+    for (int i = 0; i < NUM_POSITIONS; i++) {
+        positions[i].type = (PieceType)rng_range(&rng, PIECE_COUNT);
+        positions[i].rotation = (RotationState)rng_range(&rng, 4);
+        positions[i].x = (int)rng_range(&rng, BOARD_WIDTH + 2) - 2;
+        positions[i].y = (int)rng_range(&rng, BOARD_HEIGHT);
+    }
+}
+
+/* Stop the suite: an optimized function disagreed with its reference */
+static void check_failed(const char* name, long index) {
+    fprintf(stderr, "bench: %s differs from its reference (case %ld)\n", name, index);
+    exit(EXIT_FAILURE);
+}
+
+/* Print one differential check result */
+static void report_check(const char* name, long cases, long iterations,
+                         double ref_seconds, double seconds) {
+    printf("check=%s cases=%ld ref_ns_per_op=%.2f ns_per_op=%.2f speedup=%.2f\n",
+           name, cases, ref_seconds * 1e9 / (double)iterations,
+           seconds * 1e9 / (double)iterations, ref_seconds / seconds);
+    fflush(stdout);
+}
+
+/* Every random position on every random board, then both timed */
+static void check_collision(void) {
+    const long iterations = 5000000;
+    long cases = 0;
+
+    for (int b = 0; b < NUM_BOARDS; b++) {
+        for (int i = 0; i < NUM_POSITIONS; i++) {
+            const BenchPosition* p = &positions[i];
+            if (board_check_collision(&boards[b], p->type, p->rotation, p->x, p->y) !=
+                board_check_collision_scalar(&boards[b], p->type, p->rotation, p->x, p->y)) {
+                check_failed("board_check_collision", cases);
+            }
+            cases++;
+        }
+    }
+
+    long hits = 0;
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        const BenchPosition* p = &positions[i % NUM_POSITIONS];
+        hits += board_check_collision_scalar(&boards[i % NUM_BOARDS], p->type,
+                                             p->rotation, p->x, p->y);
+    }
+    double ref_seconds = now() - start;
+
+    start = now();
+    for (long i = 0; i < iterations; i++) {
+        const BenchPosition* p = &positions[i % NUM_POSITIONS];
+        hits += board_check_collision(&boards[i % NUM_BOARDS], p->type,
+                                      p->rotation, p->x, p->y);
+    }
+    report_check("board_check_collision", cases, iterations, ref_seconds, now() - start);
+    bench_sink += hits;
+}
+
+/* Random boards with up to four full rows anywhere and a locked piece
+ * for color variety; the whole Board must match after the clear */
+static void check_clear_lines(void) {
+    const long iterations = 1000000;
+    static Board sources[NUM_BOARDS];
+    Board board;
+    Board reference;
+    Rng rng;
+
+    rng_seed(&rng, BENCH_SEED ^ 0x636C656172ULL);
+    for (int i = 0; i < NUM_BOARDS; i++) {
+        board_row_t rows[BOARD_HEIGHT];
+        memcpy(rows, boards[i].rows, sizeof(rows));
+        int lines = (int)rng_range(&rng, 5);
+        for (int n = 0; n < lines; n++) {
+            rows[rng_range(&rng, BOARD_HEIGHT)] = BOARD_FULL_ROW;
+        }
+        board_load_rows(&sources[i], rows);
+
+        const BenchPosition* p = &positions[i % NUM_POSITIONS];
+        if (!board_check_collision(&sources[i], p->type, p->rotation, p->x, p->y)) {
+            board_lock_piece(&sources[i], p->type, p->rotation, p->x, p->y);
+        }
+    }
+
+    for (int i = 0; i < NUM_BOARDS; i++) {
+        board = sources[i];
+        reference = sources[i];
+        if (board_clear_lines(&board) != board_clear_lines_scalar(&reference) ||
+            memcmp(&board, &reference, sizeof(board)) != 0) {
+            check_failed("board_clear_lines", i);
+        }
+    }
+
+    long sum = 0;
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        memcpy(&board, &sources[i % NUM_BOARDS], sizeof(board));
+        sum += board_clear_lines_scalar(&board);
+    }
+    double ref_seconds = now() - start;
+
+    start = now();
+    for (long i = 0; i < iterations; i++) {
+        memcpy(&board, &sources[i % NUM_BOARDS], sizeof(board));
+        sum += board_clear_lines(&board);
+    }
+    report_check("board_clear_lines", NUM_BOARDS, iterations, ref_seconds, now() - start);
+    bench_sink += sum;
+}
+
+static void bench_collision(void) {
+    const long iterations = 20000000;
+    long hits = 0;
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        const BenchPosition* p = &positions[i % NUM_POSITIONS];
+        hits += board_check_collision(&boards[i % NUM_BOARDS], p->type,
+                                      p->rotation, p->x, p->y);
+    }
+    report("board_check_collision", iterations, now() - start);
+    bench_sink += hits;
+}
+
+/* Clearing mutates the board, so each iteration starts from a copy; the
+ * board_copy line gives the copy cost on its own */
+static void bench_board_copy(void) {
+    const long iterations = 5000000;
+    Board board;
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        memcpy(&board, &boards[i % NUM_BOARDS], sizeof(board));
+        bench_sink += board.rows[BOARD_HEIGHT - 1];
+    }
+    report("board_copy", iterations, now() - start);
+}
+
+static void bench_clear_lines(int lines) {
+    const long iterations = 5000000;
+    Board sources[NUM_BOARDS];
+    Board board;
+    char name[32];
+
+    /* Fill `lines` rows spread over the stack (bottom row always) */
+    for (int i = 0; i < NUM_BOARDS; i++) {
+        board_row_t rows[BOARD_HEIGHT];
+        memcpy(rows, boards[i].rows, sizeof(rows));
+        for (int n = 0; n < lines; n++) {
+            rows[BOARD_HEIGHT - 1 - n * 2] = BOARD_FULL_ROW;
+        }
+        board_load_rows(&sources[i], rows);
+    }
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        memcpy(&board, &sources[i % NUM_BOARDS], sizeof(board));
+        bench_sink += board_clear_lines(&board);
+    }
+    snprintf(name, sizeof(name), "board_clear_lines_%d", lines);
+    report(name, iterations, now() - start);
+}
+
+static void bench_drop_y(void) {
+    const long iterations = 20000000;
+    long sum = 0;
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        const BenchPosition* p = &positions[i % NUM_POSITIONS];
+        const Board* board = &boards[i % NUM_BOARDS];
+        int x = p->x < 0 ? 0 : p->x;
+        sum += board_drop_y(board, p->type, p->rotation,
+                            x > BOARD_WIDTH - 4 ? BOARD_WIDTH - 4 : x, 0);
+    }
+    report("board_drop_y", iterations, now() - start);
+    bench_sink += sum;
+}
+
+/* Games on random boards, shared by the ghost and rotate benches */
+static void setup_games(Game* games) {
+    for (int i = 0; i < NUM_BOARDS; i++) {
+        game_init_seeded(&games[i], BENCH_SEED + (uint64_t)i);
+        game_set_starting_level(&games[i], 1);
+        GameSnapshot snapshot;
+        game_snapshot(&games[i], &snapshot);
+        board_pack(&boards[i], snapshot.cells);
+        snapshot.piece_y = 0;
+        game_restore(&games[i], &snapshot);
+    }
+}
+
+static void bench_ghost_y(Game* games) {
+    const long iterations = 50000000;
+    long sum = 0;
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        sum += game_get_ghost_y(&games[i % NUM_BOARDS]);
+    }
+    report("game_get_ghost_y", iterations, now() - start);
+    bench_sink += sum;
+}
+
+static void bench_rotate(Game* games) {
+    const long iterations = 10000000;
+    long rotated = 0;
+
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        rotated += game_rotate(&games[i % NUM_BOARDS]);
+    }
+    report("game_rotate", iterations, now() - start);
+    bench_sink += rotated;
+}
+
+/* Untouched games falling under gravity, one frame per call versus
+ * game_step_frames jumping between gravity steps and locks */
+static void bench_step_frames(void) {
+    const long frames = 20000000;
+    const int chunk = 600;  /* 10 seconds of play per call */
+    Game game;
+
+    game_init_seeded(&game, BENCH_SEED);
+    game_set_starting_level(&game, 1);
+    double start = now();
+    for (long i = 0; i < frames; i++) {
+        if (game.state != GAME_STATE_PLAYING) {
+            game_init_seeded(&game, BENCH_SEED + (uint64_t)i);
+            game_set_starting_level(&game, 1);
+        }
+        game_step_frame(&game);
+    }
+    report("game_step_frame", frames, now() - start);
+    bench_sink += game.score;
+
+    game_init_seeded(&game, BENCH_SEED);
+    game_set_starting_level(&game, 1);
+    start = now();
+    for (long i = 0; i < frames; i += chunk) {
+        if (game.state != GAME_STATE_PLAYING) {
+            game_init_seeded(&game, BENCH_SEED + (uint64_t)i);
+            game_set_starting_level(&game, 1);
+        }
+        game_step_frames(&game, chunk);
+    }
+    report("game_step_frames", frames, now() - start);
+    bench_sink += game.score;
+}
+
+/* Greedy placement policy: lowest aggregate height + holes + bumpiness */
+static Action greedy_policy(const Game* game, void* ctx) {
+    Placement placements[BOARD_MAX_PLACEMENTS];
+    int count = board_enumerate_placements(&game->board, game->current_piece,
+                                           placements);
+    Action action = {ACTION_HARD_DROP, ROT_0, 0};
+    int best_score = 0;
+    (void)ctx;
+
+    for (int i = 0; i < count; i++) {
+        Board board = game->board;
+        BoardFeatures features;
+
+        board_lock_piece(&board, game->current_piece, placements[i].rotation,
+                         placements[i].x, placements[i].y);
+        int lines = board_clear_lines(&board);
+        board_features(&board, &features);
+
+        int score = 5 * features.aggregate_height + 35 * features.holes +
+                    2 * features.bumpiness - 8 * lines;
+        if (action.type != ACTION_PLACE || score < best_score) {
+            action.type = ACTION_PLACE;
+            action.rotation = placements[i].rotation;
+            action.x = placements[i].x;
+            best_score = score;
+        }
+    }
+
+    return action;
+}
+
+/* Random-action policy: games end quickly, exercises the frame loop */
+static Action random_policy(const Game* game, void* ctx) {
+    Rng* rng = (Rng*)ctx;
+    Action action = {ACTION_NONE, ROT_0, 0};
+    (void)game;
+
+    action.type = (ActionType)rng_range(rng, ACTION_PLACE);
+    return action;
+}
+
+/* Lock hook of a checked game: replays the lock on the pre-lock board
+ * with the reference clear and compares the result with the game's */
+static void check_lock_hook(const Game* game, const GameLockEvent* event, void* ctx) {
+    long* locks = (long*)ctx;
+    Board reference = *event->board;
+
+    board_lock_piece(&reference, event->piece, event->rotation, event->x, event->y);
+    if (board_clear_lines_scalar(&reference) != event->lines ||
+        memcmp(&reference, &game->board, sizeof(reference)) != 0) {
+        check_failed("board_clear_lines (in game)", *locks);
+    }
+    (*locks)++;
+}
+
+/* Play random and greedy games, checking the ghost row and the current
+ * piece's collisions every frame and the board after every lock; then
+ * time the ghost row against the reference scan */
+static void check_games(Game* games) {
+    const long iterations = 5000000;
+    static const int dx[] = {0, -1, 1, 0};
+    static const int dy[] = {1, 0, 0, 0};
+    long frames = 0;
+    long locks = 0;
+    Game game;
+    Rng rng;
+
+    rng_seed(&rng, BENCH_SEED ^ 0x67616D6573ULL);
+    for (int g = 0; g < CHECK_GAMES; g++) {
+        game_init_randomized(&game, BENCH_SEED + (uint64_t)g,
+                             (Randomizer)(g % RANDOMIZER_COUNT));
+        game_set_starting_level(&game, 1 + g % 10);
+        game_set_lock_hook(&game, check_lock_hook, &locks, true);
+
+        for (int step = 0; step < CHECK_STEP_LIMIT && game.state == GAME_STATE_PLAYING;
+             step++) {
+            if (game_get_ghost_y(&game) != game_get_ghost_y_scalar(&game)) {
+                check_failed("game_get_ghost_y", frames);
+            }
+            for (int i = 0; i < 4; i++) {
+                int x = game.piece_x + dx[i];
+                int y = game.piece_y + dy[i];
+                if (board_check_collision(&game.board, game.current_piece,
+                                          game.current_rotation, x, y) !=
+                    board_check_collision_scalar(&game.board, game.current_piece,
+                                                 game.current_rotation, x, y)) {
+                    check_failed("board_check_collision (in game)", frames);
+                }
+            }
+
+            /* Odd games place greedily (clearing lines); even games press
+             * random keys, with a new piece every few frames */
+            Action action = g % 2 != 0 ? greedy_policy(&game, NULL)
+                                       : random_policy(&game, &rng);
+            if (g % 2 != 0 || rng_range(&rng, 4) == 0) {
+                game_apply_action(&game, &action);
+            }
+            game_step_frame(&game);
+            frames++;
+        }
+    }
+
+    long sum = 0;
+    double start = now();
+    for (long i = 0; i < iterations; i++) {
+        sum += game_get_ghost_y_scalar(&games[i % NUM_BOARDS]);
+    }
+    double ref_seconds = now() - start;
+
+    start = now();
+    for (long i = 0; i < iterations; i++) {
+        sum += game_get_ghost_y(&games[i % NUM_BOARDS]);
+    }
+    report_check("game_get_ghost_y", frames, iterations, ref_seconds, now() - start);
+    printf("check=game_locks cases=%ld\n", locks);
+    bench_sink += sum;
+}
+
+/* Corpus check: the writing hook plus the records it should produce */
+typedef struct {
+    CorpusWriter writer;
+    CorpusRecord expected[CORPUS_GAMES * CORPUS_PIECES];
+    long count;
+} CorpusCheck;
+
+/* Lock hook of a corpus game: remembers each lock, then appends it */
+static void corpus_check_hook(const Game* game, const GameLockEvent* event, void* ctx) {
+    CorpusCheck* check = (CorpusCheck*)ctx;
+    CorpusRecord* record = &check->expected[check->count++];
+
+    memset(record, 0, sizeof(*record));
+    record->game_id = check->writer.game_id;
+    record->score_delta = event->score_delta;
+    board_pack(event->board, record->cells);
+    record->piece = (uint8_t)event->piece;
+    record->next_piece = (uint8_t)event->next_piece;
+    record->rotation = (uint8_t)event->rotation;
+    record->x = (int8_t)event->x;
+    record->y = (int8_t)event->y;
+    record->lines = (uint8_t)event->lines;
+    corpus_lock_hook(game, event, &check->writer);
+}
+
+/* Append greedy games to an open corpus writer, one game id each */
+static void write_corpus_games(CorpusCheck* check, int first, int count) {
+    Game game;
+
+    for (int g = first; g < first + count; g++) {
+        game_init_seeded(&game, BENCH_SEED + (uint64_t)g);
+        game_set_starting_level(&game, 1);
+        game_set_lock_hook(&game, corpus_check_hook, check, true);
+
+        for (int piece = 0; piece < CORPUS_PIECES && game.state == GAME_STATE_PLAYING;
+             piece++) {
+            Action action = greedy_policy(&game, NULL);
+            game_apply_action(&game, &action);
+        }
+        check->writer.game_id++;
+    }
+}
+
+/* Write greedy games to a corpus in two sessions with a torn record
+ * between them, then map it and compare every record with its lock */
+static void check_corpus(void) {
+    static CorpusCheck check;
+    char path[] = "/tmp/ntris-bench-corpus.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("bench: corpus file");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+
+    /* First session, then a crash halfway through the next append */
+    if (!corpus_writer_open(&check.writer, path)) {
+        check_failed("corpus_writer_open", 0);
+    }
+    write_corpus_games(&check, 0, CORPUS_GAMES / 2);
+    if (!corpus_writer_close(&check.writer)) {
+        check_failed("corpus_writer_close", check.count);
+    }
+    FILE* file = fopen(path, "ab");
+    if (file == NULL || fwrite(&check.expected[0], sizeof(CorpusRecord) / 2, 1, file) != 1 ||
+        fclose(file) != 0) {
+        check_failed("corpus torn append", check.count);
+    }
+
+    /* Reopening drops the torn tail and numbers games on from the last */
+    if (!corpus_writer_open(&check.writer, path) ||
+        check.writer.game_id != CORPUS_GAMES / 2) {
+        check_failed("corpus_writer_open (reopen)", check.count);
+    }
+    write_corpus_games(&check, CORPUS_GAMES / 2, CORPUS_GAMES - CORPUS_GAMES / 2);
+    if (!corpus_writer_close(&check.writer)) {
+        check_failed("corpus_writer_close", check.count);
+    }
+
+    CorpusReader reader;
+    if (!corpus_open(&reader, path) || reader.count != (size_t)check.count) {
+        check_failed("corpus_open", check.count);
+    }
+    for (long i = 0; i < check.count; i++) {
+        if (memcmp(&reader.records[i], &check.expected[i], sizeof(CorpusRecord)) != 0) {
+            check_failed("corpus record", i);
+        }
+    }
+    corpus_close(&reader);
+    unlink(path);
+    printf("check=corpus_round_trip cases=%ld\n", check.count);
+}
+
+static void start_games(Game* games, int n) {
+    for (int i = 0; i < n; i++) {
+        game_init_seeded(&games[i], BENCH_SEED + (uint64_t)i);
+        game_set_starting_level(&games[i], 1);
+    }
+}
+
+static void bench_games(const char* name, BatchPolicy policy, int num_games,
+                        int max_steps, int threads) {
+    static Game games[MAX_GAMES];
+    BatchEngine engine;
+    Rng rng;
+
+    if (!batch_init(&engine, threads)) {
+        fprintf(stderr, "bench: batch_init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* One CPU: the all-threads run would repeat the single-thread line */
+    if (threads == 0 && engine.num_threads == 1) {
+        batch_destroy(&engine);
+        return;
+    }
+
+    /* The random policy's shared Rng is only safe on one thread */
+    rng_seed(&rng, BENCH_SEED);
+    start_games(games, num_games);
+
+    double start = now();
+    batch_rollout(&engine, games, num_games, policy, &rng, max_steps);
+    double seconds = now() - start;
+
+    long frames = 0;
+    for (int i = 0; i < num_games; i++) {
+        frames += games[i].frame_count;
+    }
+
+    char full_name[64];
+    snprintf(full_name, sizeof(full_name), "%s_t%d", name, engine.num_threads);
+    report(full_name, num_games, seconds);
+    printf("bench=%s_frames iterations=%ld ns_per_op=%.2f ops_per_sec=%.0f\n",
+           full_name, frames, seconds * 1e9 / (double)frames,
+           (double)frames / seconds);
+    batch_destroy(&engine);
+}
+
+/* Greedy 1v1 matches with garbage, all stepped together each frame */
+static void bench_matches(int num_matches) {
+    MatchEngine engine;
+
+    if (!match_init(&engine, (size_t)num_matches, 2, BENCH_SEED, 1)) {
+        fprintf(stderr, "bench: match_init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double start = now();
+    match_rollout(&engine, greedy_policy, NULL, MATCH_FRAME_LIMIT);
+    double seconds = now() - start;
+
+    long frames = 0;
+    for (int m = 0; m < num_matches; m++) {
+        frames += engine.frames[m];
+    }
+
+    report("matches_greedy", num_matches, seconds);
+    printf("bench=matches_greedy_frames iterations=%ld ns_per_op=%.2f ops_per_sec=%.0f\n",
+           frames, seconds * 1e9 / (double)frames, (double)frames / seconds);
+    match_destroy(&engine);
+}
+
+int main(void) {
+    static Game games[NUM_BOARDS];
+
+    setup_inputs();
+    setup_games(games);
+
+    /* Differential checks first: a wrong answer fails before any timing */
+    check_collision();
+    check_clear_lines();
+    check_games(games);
+    check_corpus();
+
+    bench_collision();
+    bench_board_copy();
+    for (int lines = 1; lines <= 4; lines++) {
+        bench_clear_lines(lines);
+    }
+    bench_drop_y();
+
+    bench_ghost_y(games);
+    bench_rotate(games);
+    bench_step_frames();
+
+    bench_games("games_random", random_policy, MAX_GAMES, RANDOM_STEP_LIMIT, 1);
+    bench_games("games_greedy", greedy_policy, 256, GREEDY_STEP_LIMIT, 1);
+    bench_games("games_greedy", greedy_policy, 256, GREEDY_STEP_LIMIT, 0);
+    bench_matches(128);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+#include "ansi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Shown-cell value for "unknown" (forces the cell to be sent) */
+#define CELL_UNKNOWN 0xFFFF
+
+/* Blank cell: space with default attribute */
+#define CELL_BLANK ((uint16_t)' ')
+
+/* Longest same-row gap bridged by re-sending cells instead of jumping
+ * (a cursor jump costs 6-8 bytes) */
+#define MAX_BRIDGE 4
+
+/* ANSI SGR foreground code for each color index (0 = default) */
+static const char* const SGR_COLORS[ANSI_ATTR_COLOR_MASK + 1] = {
+    "", ";36", ";33", ";35", ";32", ";31", ";34", ";37", ";37",
+    "", "", "", "", "", "", ""
+};
+
+bool ansi_screen_init(AnsiScreen* screen, int rows, int cols) {
+    size_t count = (size_t)rows * (size_t)cols;
+
+    screen->rows = rows;
+    screen->cols = cols;
+    screen->cells = malloc(count * sizeof(screen->cells[0]));
+    screen->shown = malloc(count * sizeof(screen->shown[0]));
+    screen->out = NULL;
+    screen->out_len = 0;
+    screen->out_cap = 0;
+    if (screen->cells == NULL || screen->shown == NULL) {
+        ansi_screen_destroy(screen);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        screen->cells[i] = CELL_BLANK;
+    }
+    ansi_screen_invalidate(screen);
+    return true;
+}
+
+void ansi_screen_invalidate(AnsiScreen* screen) {
+    size_t count = (size_t)screen->rows * (size_t)screen->cols;
+    for (size_t i = 0; i < count; i++) {
+        screen->shown[i] = CELL_UNKNOWN;
+    }
+}
+
+void ansi_screen_put(AnsiScreen* screen, int row, int col, uint8_t attr,
+                     const char* text, size_t length) {
+    if (row < 0 || row >= screen->rows) {
+        return;
+    }
+
+    uint16_t* line = &screen->cells[(size_t)row * (size_t)screen->cols];
+    for (size_t i = 0; i < length; i++) {
+        int x = col + (int)i;
+        if (x >= 0 && x < screen->cols) {
+            line[x] = (uint16_t)((unsigned char)text[i] | attr << 8);
+        }
+    }
+}
+
+void ansi_screen_fill(AnsiScreen* screen, int row, int col, int height, int width,
+                      char ch, uint8_t attr) {
+    uint16_t cell = (uint16_t)((unsigned char)ch | attr << 8);
+
+    for (int y = row; y < row + height; y++) {
+        if (y < 0 || y >= screen->rows) {
+            continue;
+        }
+        uint16_t* line = &screen->cells[(size_t)y * (size_t)screen->cols];
+        for (int x = col; x < col + width; x++) {
+            if (x >= 0 && x < screen->cols) {
+                line[x] = cell;
+            }
+        }
+    }
+}
+
+void ansi_screen_emit(AnsiScreen* screen, const char* bytes, size_t length) {
+    if (screen->out_len + length > screen->out_cap) {
+        size_t capacity = screen->out_cap > 0 ? screen->out_cap : 4096;
+        while (capacity < screen->out_len + length) {
+            capacity *= 2;
+        }
+        char* grown = realloc(screen->out, capacity);
+        if (grown == NULL) {
+            return;  /* Out of memory: these bytes are dropped */
+        }
+        screen->out = grown;
+        screen->out_cap = capacity;
+    }
+
+    memcpy(screen->out + screen->out_len, bytes, length);
+    screen->out_len += length;
+}
+
+/* Append the SGR sequence selecting an attribute */
+static void emit_attr(AnsiScreen* screen, uint8_t attr) {
+    char sgr[24];
+    int length = snprintf(sgr, sizeof(sgr), "\033[0%s%s%sm",
+                          (attr & ANSI_ATTR_DIM) ? ";2" : "",
+                          (attr & ANSI_ATTR_REVERSE) ? ";7" : "",
+                          SGR_COLORS[attr & ANSI_ATTR_COLOR_MASK]);
+    ansi_screen_emit(screen, sgr, (size_t)length);
+}
+
+size_t ansi_screen_flush(AnsiScreen* screen) {
+    int cursor_row = -1;  /* Unknown until the first jump */
+    int cursor_col = -1;
+    int attr = 0;         /* Every flush leaves the default attribute set */
+    char run[256];        /* Cell characters waiting to be emitted */
+    size_t run_len = 0;
+
+    /* A never-drawn screen is cleared in one go instead of cell by cell */
+    if (screen->shown[0] == CELL_UNKNOWN) {
+        static const char clear[] = "\033[0m\033[2J";
+        ansi_screen_emit(screen, clear, sizeof(clear) - 1);
+        size_t count = (size_t)screen->rows * (size_t)screen->cols;
+        for (size_t i = 0; i < count; i++) {
+            screen->shown[i] = CELL_BLANK;
+        }
+    }
+
+    for (int row = 0; row < screen->rows; row++) {
+        size_t base = (size_t)row * (size_t)screen->cols;
+
+        for (int col = 0; col < screen->cols; col++) {
+            uint16_t cell = screen->cells[base + (size_t)col];
+            if (cell == screen->shown[base + (size_t)col]) {
+                continue;
+            }
+
+            /* Get the cursor here: bridge a short gap of unchanged cells
+             * with the current attribute, otherwise jump */
+            if (cursor_row != row || cursor_col != col) {
+                int gap = col - cursor_col;
+                bool bridge = cursor_row == row && gap > 0 && gap <= MAX_BRIDGE;
+                for (int x = cursor_col; bridge && x < col; x++) {
+                    bridge = (screen->shown[base + (size_t)x] >> 8) == attr;
+                }
+
+                if (bridge) {
+                    for (int x = cursor_col; x < col; x++) {
+                        run[run_len++] = (char)(screen->shown[base + (size_t)x] & 0xFF);
+                    }
+                } else {
+                    ansi_screen_emit(screen, run, run_len);
+                    run_len = 0;
+                    char jump[24];
+                    int length = snprintf(jump, sizeof(jump), "\033[%d;%dH",
+                                          row + 1, col + 1);
+                    ansi_screen_emit(screen, jump, (size_t)length);
+                }
+            }
+
+            /* Color changes only between runs of different attributes */
+            if ((cell >> 8) != attr) {
+                ansi_screen_emit(screen, run, run_len);
+                run_len = 0;
+                attr = cell >> 8;
+                emit_attr(screen, (uint8_t)attr);
+            }
+
+            run[run_len++] = (char)(cell & 0xFF);
+            if (run_len > sizeof(run) - MAX_BRIDGE - 1) {
+                ansi_screen_emit(screen, run, run_len);
+                run_len = 0;
+            }
+            screen->shown[base + (size_t)col] = cell;
+            cursor_row = row;
+            cursor_col = col + 1;
+
+            /* Cursor position after the last column is terminal-specific */
+            if (cursor_col == screen->cols) {
+                cursor_row = -1;
+            }
+        }
+    }
+    ansi_screen_emit(screen, run, run_len);
+
+    /* Leave the terminal in the default attribute between frames */
+    if (attr != 0) {
+        static const char reset[] = "\033[0m";
+        ansi_screen_emit(screen, reset, sizeof(reset) - 1);
+    }
+
+    return screen->out_len;
+}
+
+void ansi_screen_consume(AnsiScreen* screen, size_t length) {
+    if (length >= screen->out_len) {
+        screen->out_len = 0;
+        return;
+    }
+
+    memmove(screen->out, screen->out + length, screen->out_len - length);
+    screen->out_len -= length;
+}
+
+void ansi_screen_destroy(AnsiScreen* screen) {
+    free(screen->cells);
+    free(screen->shown);
+    free(screen->out);
+    screen->cells = NULL;
+    screen->shown = NULL;
+    screen->out = NULL;
+    screen->out_len = 0;
+    screen->out_cap = 0;
+}
@@ -0,0 +1,120 @@
+#ifndef ANSI_H
+#define ANSI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * ansi.h - Virtual screen that renders to raw ANSI/VT100 escape sequences
+ *
+ * Drawing code writes characters and attributes into an in-memory grid;
+ * ansi_screen_flush compares it with what the terminal is known to show
+ * and appends only the differences to a reusable byte buffer:
+ *
+ * - An SGR (color) sequence is emitted only where the attribute changes,
+ *   so a run of same-colored cells costs one color change.
+ * - The cursor is positioned only where the next change is not where the
+ *   cursor already is; short gaps on the same row are bridged by
+ *   re-sending the unchanged cells when that is cheaper than a jump.
+ *
+ * The caller sends the buffer in one write() per frame (or hands it to a
+ * network session) and then clears it with ansi_screen_consume.
+ */
+
+/* Cell attributes: color (0 = default, 1-8 = ANSI_COLOR_* index) plus flags */
+#define ANSI_ATTR_COLOR_MASK 0x0F
+#define ANSI_ATTR_DIM 0x10
+#define ANSI_ATTR_REVERSE 0x20
+
+typedef struct {
+    int rows;
+    int cols;
+    uint16_t* cells;  /* Current frame: character | attribute << 8 */
+    uint16_t* shown;  /* Contents the terminal displays */
+
+    /* Escape sequences produced by flushes, not yet consumed */
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+} AnsiScreen;
+
+/**
+ * Allocate a rows x cols screen. The first flush clears the terminal.
+ *
+ * @param screen Pointer to screen structure
+ * @param rows Terminal rows
+ * @param cols Terminal columns
+ * @return true on success, false if out of memory
+ */
+bool ansi_screen_init(AnsiScreen* screen, int rows, int cols);
+
+/**
+ * Forget what the terminal shows: the next flush clears and redraws all.
+ *
+ * @param screen Pointer to initialized screen
+ */
+void ansi_screen_invalidate(AnsiScreen* screen);
+
+/**
+ * Write text at a position with one attribute (clipped to the screen).
+ *
+ * @param screen Pointer to initialized screen
+ * @param row Row (0-based)
+ * @param col Column (0-based)
+ * @param attr Attribute byte (color | ANSI_ATTR_* flags)
+ * @param text Characters to write (one cell each)
+ * @param length Number of characters
+ */
+void ansi_screen_put(AnsiScreen* screen, int row, int col, uint8_t attr,
+                     const char* text, size_t length);
+
+/**
+ * Fill a rectangle with one character and attribute (clipped).
+ *
+ * @param screen Pointer to initialized screen
+ * @param row Top row
+ * @param col Left column
+ * @param height Number of rows
+ * @param width Number of columns
+ * @param ch Fill character
+ * @param attr Attribute byte
+ */
+void ansi_screen_fill(AnsiScreen* screen, int row, int col, int height, int width,
+                      char ch, uint8_t attr);
+
+/**
+ * Append raw bytes to the output buffer (mode switches, cursor
+ * visibility, bell). They are sent ahead of the next flush's changes.
+ *
+ * @param screen Pointer to initialized screen
+ * @param bytes Bytes to append
+ * @param length Number of bytes
+ */
+void ansi_screen_emit(AnsiScreen* screen, const char* bytes, size_t length);
+
+/**
+ * Append the escape sequences that bring the terminal from what it
+ * shows to the current frame. A frame without changes appends nothing.
+ *
+ * @param screen Pointer to initialized screen
+ * @return Total bytes now waiting in the output buffer
+ */
+size_t ansi_screen_flush(AnsiScreen* screen);
+
+/**
+ * Drop the first length bytes of the output buffer (after sending them).
+ *
+ * @param screen Pointer to initialized screen
+ * @param length Bytes sent
+ */
+void ansi_screen_consume(AnsiScreen* screen, size_t length);
+
+/**
+ * Free the screen's memory.
+ *
+ * @param screen Pointer to initialized screen
+ */
+void ansi_screen_destroy(AnsiScreen* screen);
+
+#endif /* ANSI_H */
@@ -0,0 +1,41 @@
+#include "arena.h"
+
+/* Initialize arena over a buffer */
+void arena_init(Arena* arena, void* buffer, size_t size) {
+    arena->base = (uint8_t*)buffer;
+    arena->size = size;
+    arena->used = 0;
+}
+
+/* Allocate an aligned block by bumping the offset */
+void* arena_alloc(Arena* arena, size_t size, size_t align) {
+    /* Align the address, not just the offset, so any buffer works */
+    uintptr_t start = (uintptr_t)(arena->base + arena->used);
+    size_t padding = (size_t)(-start & (uintptr_t)(align - 1));
+
+    if (padding > arena->size - arena->used ||
+        size > arena->size - arena->used - padding) {
+        return NULL;  /* Out of space */
+    }
+
+    void* block = arena->base + arena->used + padding;
+    arena->used += padding + size;
+    return block;
+}
+
+/* Release everything */
+void arena_reset(Arena* arena) {
+    arena->used = 0;
+}
+
+/* Get current position */
+size_t arena_mark(const Arena* arena) {
+    return arena->used;
+}
+
+/* Release allocations made since mark */
+void arena_rewind(Arena* arena, size_t mark) {
+    if (mark < arena->used) {
+        arena->used = mark;
+    }
+}
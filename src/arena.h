@@ -0,0 +1,67 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * arena.h - Bump allocator over a caller-provided buffer
+ *
+ * Allocation advances a single offset; everything is released at once with
+ * arena_reset (or back to a saved mark with arena_rewind), so short-lived
+ * search nodes cost no malloc/free. The arena never owns its buffer and
+ * is not thread-safe: give each thread its own.
+ */
+
+typedef struct {
+    uint8_t* base;  /* Caller-owned backing buffer */
+    size_t size;    /* Buffer size in bytes */
+    size_t used;    /* Bytes handed out so far */
+} Arena;
+
+/* Alignment that suits every type stored in the library's arenas */
+#define ARENA_DEFAULT_ALIGN 8
+
+/**
+ * Initialize arena over a buffer.
+ *
+ * @param arena Pointer to arena
+ * @param buffer Backing memory (must outlive the arena)
+ * @param size Size of buffer in bytes
+ */
+void arena_init(Arena* arena, void* buffer, size_t size);
+
+/**
+ * Allocate a block from the arena.
+ *
+ * @param arena Pointer to arena
+ * @param size Bytes to allocate
+ * @param align Required alignment (power of two)
+ * @return Pointer to uninitialized block, or NULL if the arena is full
+ */
+void* arena_alloc(Arena* arena, size_t size, size_t align);
+
+/**
+ * Release every allocation in O(1).
+ *
+ * @param arena Pointer to arena
+ */
+void arena_reset(Arena* arena);
+
+/**
+ * Get current position, for releasing later allocations with arena_rewind.
+ *
+ * @param arena Pointer to arena
+ * @return Opaque mark
+ */
+size_t arena_mark(const Arena* arena);
+
+/**
+ * Release every allocation made since mark was taken.
+ *
+ * @param arena Pointer to arena
+ * @param mark Value returned by arena_mark on this arena
+ */
+void arena_rewind(Arena* arena, size_t mark);
+
+#endif /* ARENA_H */
@@ -0,0 +1,270 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+#include <unistd.h>
+
+/* Target number of chunks per worker (more chunks = finer stealing) */
+#define CHUNKS_PER_WORKER 8
+
+/* Pack/unpack a worker's [begin, end) chunk range into one atomic word */
+static uint64_t pack_range(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | end;
+}
+
+/* Take the next chunk from the front of the worker's own range */
+static bool pop_front(BatchWorker* worker, uint32_t* chunk) {
+    uint64_t range = __atomic_load_n(&worker->range, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+        if (begin >= end) {
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&worker->range, &range,
+                                        pack_range(begin + 1, end), true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *chunk = begin;
+            return true;
+        }
+    }
+}
+
+/* Steal a chunk from the back of another worker's range */
+static bool steal_back(BatchWorker* victim, uint32_t* chunk) {
+    uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+        if (begin >= end) {
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&victim->range, &range,
+                                        pack_range(begin, end - 1), true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *chunk = end - 1;
+            return true;
+        }
+    }
+}
+
+/* Run the current job on one chunk of games */
+static void process_chunk(BatchEngine* engine, BatchWorker* worker, uint32_t chunk) {
+    size_t first = (size_t)chunk * engine->chunk_size;
+    size_t last = first + engine->chunk_size;
+    if (last > engine->num_games) {
+        last = engine->num_games;
+    }
+
+    for (size_t i = first; i < last; i++) {
+        Game* game = &engine->games[i];
+
+        if (engine->kind == BATCH_JOB_STEP) {
+            if (game->state == GAME_STATE_PLAYING) {
+                game_apply_action(game, &engine->actions[i]);
+                game_step_frame(game);
+            }
+            continue;
+        }
+
+        /* Rollout: play this game to completion */
+        int steps = 0;
+        while (game->state == GAME_STATE_PLAYING &&
+               (engine->max_steps <= 0 || steps < engine->max_steps)) {
+            Action action;
+            if (engine->arenas != NULL) {
+                Arena* scratch = &engine->arenas[worker->index];
+                arena_reset(scratch);
+                action = engine->arena_policy(game, scratch, engine->policy_ctx);
+            } else {
+                action = engine->policy(game, engine->policy_ctx);
+            }
+            game_apply_action(game, &action);
+            game_step_frame(game);
+            steps++;
+        }
+    }
+}
+
+/* Drain own range, then steal from the others until all are empty */
+static void worker_run(BatchWorker* worker) {
+    BatchEngine* engine = worker->engine;
+    uint32_t chunk;
+
+    while (pop_front(worker, &chunk)) {
+        process_chunk(engine, worker, chunk);
+    }
+
+    for (int i = 1; i < engine->num_threads; i++) {
+        BatchWorker* victim = &engine->workers[(worker->index + i) % engine->num_threads];
+        while (steal_back(victim, &chunk)) {
+            process_chunk(engine, worker, chunk);
+        }
+    }
+}
+
+/* Worker thread entry point: wait for jobs until shutdown */
+static void* worker_main(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    BatchEngine* engine = worker->engine;
+    unsigned int seen_generation = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&engine->lock);
+        while (!engine->shutdown && engine->generation == seen_generation) {
+            pthread_cond_wait(&engine->work_ready, &engine->lock);
+        }
+        if (engine->shutdown) {
+            pthread_mutex_unlock(&engine->lock);
+            break;
+        }
+        seen_generation = engine->generation;
+        pthread_mutex_unlock(&engine->lock);
+
+        worker_run(worker);
+
+        pthread_mutex_lock(&engine->lock);
+        engine->active_workers--;
+        if (engine->active_workers == 0) {
+            pthread_cond_signal(&engine->work_done);
+        }
+        pthread_mutex_unlock(&engine->lock);
+    }
+
+    return NULL;
+}
+
+/* Deal chunks out to all workers, run share on caller, wait for the rest */
+static void run_job(BatchEngine* engine) {
+    if (engine->num_games == 0) {
+        return;
+    }
+
+    size_t target_chunks = (size_t)engine->num_threads * CHUNKS_PER_WORKER;
+    engine->chunk_size = (engine->num_games + target_chunks - 1) / target_chunks;
+    uint32_t chunks = (uint32_t)((engine->num_games + engine->chunk_size - 1) /
+                                 engine->chunk_size);
+
+    for (int i = 0; i < engine->num_threads; i++) {
+        uint32_t begin = (uint32_t)((uint64_t)chunks * (uint64_t)i /
+                                    (uint64_t)engine->num_threads);
+        uint32_t end = (uint32_t)((uint64_t)chunks * (uint64_t)(i + 1) /
+                                  (uint64_t)engine->num_threads);
+        __atomic_store_n(&engine->workers[i].range, pack_range(begin, end),
+                         __ATOMIC_RELEASE);
+    }
+
+    if (engine->num_threads > 1) {
+        pthread_mutex_lock(&engine->lock);
+        engine->generation++;
+        engine->active_workers = engine->num_threads - 1;
+        pthread_cond_broadcast(&engine->work_ready);
+        pthread_mutex_unlock(&engine->lock);
+    }
+
+    worker_run(&engine->workers[0]);
+
+    if (engine->num_threads > 1) {
+        pthread_mutex_lock(&engine->lock);
+        while (engine->active_workers > 0) {
+            pthread_cond_wait(&engine->work_done, &engine->lock);
+        }
+        pthread_mutex_unlock(&engine->lock);
+    }
+}
+
+/* Initialize engine and start worker threads */
+bool batch_init(BatchEngine* engine, int num_threads) {
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (num_threads > BATCH_MAX_THREADS) {
+        num_threads = BATCH_MAX_THREADS;
+    }
+
+    engine->num_threads = 1;
+    engine->generation = 0;
+    engine->active_workers = 0;
+    engine->shutdown = false;
+    engine->games = NULL;
+    engine->arenas = NULL;
+    engine->num_games = 0;
+    pthread_mutex_init(&engine->lock, NULL);
+    pthread_cond_init(&engine->work_ready, NULL);
+    pthread_cond_init(&engine->work_done, NULL);
+
+    for (int i = 0; i < num_threads; i++) {
+        engine->workers[i].engine = engine;
+        engine->workers[i].index = i;
+        engine->workers[i].range = 0;
+    }
+
+    /* Worker 0 is the calling thread; start the others */
+    for (int i = 1; i < num_threads; i++) {
+        if (pthread_create(&engine->workers[i].thread, NULL,
+                           worker_main, &engine->workers[i]) != 0) {
+            batch_destroy(engine);
+            return false;
+        }
+        engine->num_threads = i + 1;
+    }
+
+    return true;
+}
+
+/* Step all games in lockstep */
+void batch_step(BatchEngine* engine, Game* games, size_t n, const Action* actions) {
+    engine->kind = BATCH_JOB_STEP;
+    engine->games = games;
+    engine->num_games = n;
+    engine->actions = actions;
+    run_job(engine);
+}
+
+/* Play all games to completion */
+void batch_rollout(BatchEngine* engine, Game* games, size_t n,
+                   BatchPolicy policy, void* ctx, int max_steps) {
+    engine->kind = BATCH_JOB_ROLLOUT;
+    engine->games = games;
+    engine->num_games = n;
+    engine->policy = policy;
+    engine->arenas = NULL;
+    engine->policy_ctx = ctx;
+    engine->max_steps = max_steps;
+    run_job(engine);
+}
+
+/* Play all games to completion with per-thread scratch arenas */
+void batch_rollout_arena(BatchEngine* engine, Game* games, size_t n,
+                         BatchArenaPolicy policy, void* ctx, Arena* arenas,
+                         int max_steps) {
+    engine->kind = BATCH_JOB_ROLLOUT;
+    engine->games = games;
+    engine->num_games = n;
+    engine->arena_policy = policy;
+    engine->arenas = arenas;
+    engine->policy_ctx = ctx;
+    engine->max_steps = max_steps;
+    run_job(engine);
+}
+
+/* Stop and join worker threads */
+void batch_destroy(BatchEngine* engine) {
+    pthread_mutex_lock(&engine->lock);
+    engine->shutdown = true;
+    pthread_cond_broadcast(&engine->work_ready);
+    pthread_mutex_unlock(&engine->lock);
+
+    for (int i = 1; i < engine->num_threads; i++) {
+        pthread_join(engine->workers[i].thread, NULL);
+    }
+    engine->num_threads = 1;
+
+    pthread_cond_destroy(&engine->work_done);
+    pthread_cond_destroy(&engine->work_ready);
+    pthread_mutex_destroy(&engine->lock);
+}
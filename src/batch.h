@@ -0,0 +1,138 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "game.h"
+
+/**
+ * batch.h - Batch rollout engine for headless simulation
+ *
+ * Steps many independent Games at once on a fixed pool of worker threads.
+ * Each call splits the games into chunks that are dealt out evenly to
+ * the workers; a worker that runs out of chunks steals the remaining ones
+ * from the back of another worker's range, so uneven game lengths do not
+ * leave cores idle. The calling thread takes part as worker 0.
+ *
+ * All game logic is the regular game.c code path (game_apply_action,
+ * game_step_frame), so batch results match single-game results exactly.
+ */
+
+#define BATCH_MAX_THREADS 64
+
+/**
+ * Policy callback for rollouts: choose the next action for a game.
+ * Called concurrently from several worker threads (must be thread-safe).
+ */
+typedef Action (*BatchPolicy)(const Game* game, void* ctx);
+
+/**
+ * Policy callback with per-thread scratch memory. The arena belongs to
+ * the calling worker and is reset before every call, so a policy can
+ * allocate search nodes freely without ever freeing them.
+ */
+typedef Action (*BatchArenaPolicy)(const Game* game, Arena* scratch, void* ctx);
+
+struct BatchEngine;
+
+/* Per-thread worker state */
+typedef struct {
+    struct BatchEngine* engine;
+    pthread_t thread;
+    int index;
+    uint64_t range;  /* Packed chunk range: begin << 32 | end (atomic) */
+} BatchWorker;
+
+/* Kind of job currently dispatched to the workers */
+typedef enum {
+    BATCH_JOB_STEP,
+    BATCH_JOB_ROLLOUT
+} BatchJobKind;
+
+typedef struct BatchEngine {
+    BatchWorker workers[BATCH_MAX_THREADS];
+    int num_threads;  /* Including the calling thread */
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    unsigned int generation;  /* Bumped for each dispatched job */
+    int active_workers;       /* Workers still running current job */
+    bool shutdown;
+
+    /* Current job */
+    BatchJobKind kind;
+    Game* games;
+    size_t num_games;
+    size_t chunk_size;
+    const Action* actions;
+    BatchPolicy policy;
+    BatchArenaPolicy arena_policy;  /* Used instead of policy if arenas set */
+    Arena* arenas;                  /* One scratch arena per thread */
+    void* policy_ctx;
+    int max_steps;
+} BatchEngine;
+
+/**
+ * Initialize engine and start its worker threads.
+ *
+ * @param engine Pointer to engine structure
+ * @param num_threads Total threads including the caller (0 = one per online CPU)
+ * @return true on success, false if threads could not be started
+ */
+bool batch_init(BatchEngine* engine, int num_threads);
+
+/**
+ * Step all games in lockstep: apply actions[i] to games[i], then advance
+ * each game by one frame (game_step_frame). Games that are not in
+ * GAME_STATE_PLAYING are left untouched. Returns when all games are done.
+ *
+ * @param engine Pointer to initialized engine
+ * @param games Array of n games
+ * @param n Number of games
+ * @param actions Array of n actions (one per game)
+ */
+void batch_step(BatchEngine* engine, Game* games, size_t n, const Action* actions);
+
+/**
+ * Play every game until game over (or max_steps policy actions), asking
+ * the policy for each action and advancing one frame after each.
+ *
+ * @param engine Pointer to initialized engine
+ * @param games Array of n games (already started with game_set_starting_level)
+ * @param n Number of games
+ * @param policy Action chooser (thread-safe)
+ * @param ctx Opaque pointer passed to policy
+ * @param max_steps Per-game step limit (<= 0 for no limit)
+ */
+void batch_rollout(BatchEngine* engine, Game* games, size_t n,
+                   BatchPolicy policy, void* ctx, int max_steps);
+
+/**
+ * batch_rollout with per-thread scratch arenas for the policy. Worker i
+ * (the caller is worker 0) passes &arenas[i] to the policy, after
+ * resetting it, for each decision.
+ *
+ * @param engine Pointer to initialized engine
+ * @param games Array of n games (already started with game_set_starting_level)
+ * @param n Number of games
+ * @param policy Action chooser (thread-safe)
+ * @param ctx Opaque pointer passed to policy
+ * @param arenas Array of engine->num_threads initialized arenas
+ * @param max_steps Per-game step limit (<= 0 for no limit)
+ */
+void batch_rollout_arena(BatchEngine* engine, Game* games, size_t n,
+                         BatchArenaPolicy policy, void* ctx, Arena* arenas,
+                         int max_steps);
+
+/**
+ * Stop and join worker threads.
+ *
+ * @param engine Pointer to initialized engine
+ */
+void batch_destroy(BatchEngine* engine);
+
+#endif /* BATCH_H */
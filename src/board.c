@@ -1,43 +1,145 @@
 #include "board.h"
 #include <string.h>
 
+/* Rebuild column heights from the row masks (top-down, stops once
+ * every column has been seen) */
+static void recompute_heights(Board* board) {
+    uint32_t seen = 0;
+
+    memset(board->heights, 0, sizeof(board->heights));
+    for (int y = 0; y < BOARD_HEIGHT && seen != BOARD_FULL_ROW; y++) {
+        uint32_t tops = board->rows[y] & ~seen;
+        while (tops != 0) {
+            int x = __builtin_ctz(tops);
+            board->heights[x] = (uint8_t)(BOARD_HEIGHT - y);
+            tops &= tops - 1;
+        }
+        seen |= board->rows[y];
+    }
+}
+
 /* Initialize board to empty state */
 void board_init(Board* board) {
+    memset(board->rows, 0, sizeof(board->rows));
     memset(board->cells, 0, sizeof(board->cells));
+    memset(board->heights, 0, sizeof(board->heights));
+}
+
+/* Replace board contents from row masks */
+void board_load_rows(Board* board, const board_row_t* rows) {
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        board->rows[y] = (board_row_t)(rows[y] & BOARD_FULL_ROW);
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            board->cells[y][x] = (board->rows[y] >> x) & 1u ? BOARD_GARBAGE_COLOR : 0;
+        }
+    }
+    recompute_heights(board);
+}
+
+/* Pack occupancy bits, streaming rows into consecutive bits */
+void board_pack(const Board* board, uint8_t* out) {
+    uint64_t bits = 0;
+    int num_bits = 0;
+    int n = 0;
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        bits |= (uint64_t)board->rows[y] << num_bits;
+        num_bits += BOARD_WIDTH;
+        while (num_bits >= 8) {
+            out[n++] = (uint8_t)bits;
+            bits >>= 8;
+            num_bits -= 8;
+        }
+    }
+    if (num_bits > 0) {
+        out[n] = (uint8_t)bits;
+    }
+}
+
+/* Rebuild board from packed occupancy bits */
+void board_unpack(Board* board, const uint8_t* in) {
+    board_row_t rows[BOARD_HEIGHT];
+    uint64_t bits = 0;
+    int num_bits = 0;
+    int n = 0;
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        while (num_bits < BOARD_WIDTH) {
+            bits |= (uint64_t)in[n++] << num_bits;
+            num_bits += 8;
+        }
+        rows[y] = (board_row_t)(bits & BOARD_FULL_ROW);
+        bits >>= BOARD_WIDTH;
+        num_bits -= BOARD_WIDTH;
+    }
+    board_load_rows(board, rows);
 }
 
 /* Check if piece collides with board or boundaries */
 bool board_check_collision(const Board* board, PieceType type,
                            RotationState rotation, int x, int y) {
-    const PieceShape* shape = piece_get_shape(type, rotation);
+    return board_collides(board, piece_get_info(type, rotation), x, y);
+}
 
-    /* Check all 4 blocks of the piece */
-    for (int i = 0; i < 4; i++) {
-        int block_x = x + shape->cells[i][0];
-        int block_y = y + shape->cells[i][1];
+/* Check precomputed piece data against board */
+bool board_collides(const Board* board, const PieceInfo* info, int x, int y) {
+    /* Wall and floor collisions follow from the bounding box alone */
+    if (x + info->min_x < 0 || x + info->max_x >= BOARD_WIDTH ||
+        y + info->max_y >= BOARD_HEIGHT) {
+        return true;
+    }
 
-        /* Check left/right wall collision */
-        if (block_x < 0 || block_x >= BOARD_WIDTH) {
-            return true;
+    /* Test each occupied row of the piece against the board row mask */
+    for (int i = info->min_y; i <= info->max_y; i++) {
+        /* Allow blocks above visible area during spawn */
+        int block_y = y + i;
+        if (block_y < 0) {
+            continue;
         }
 
-        /* Check floor collision */
-        if (block_y >= BOARD_HEIGHT) {
+        /* In bounds, so shifting loses no bits */
+        uint32_t row = x >= 0 ? (uint32_t)info->rows[i] << x
+                              : (uint32_t)info->rows[i] >> -x;
+        if ((board->rows[block_y] & row) != 0) {
             return true;
         }
+    }
 
-        /* Check ceiling (allow blocks above visible area during spawn) */
-        if (block_y < 0) {
-            continue;  /* Allow pieces to extend above board during spawn */
+    return false;
+}
+
+/* Get landing row of a piece dropped from a valid position */
+int board_drop_y(const Board* board, PieceType type,
+                 RotationState rotation, int x, int y) {
+    const PieceInfo* info = piece_get_info(type, rotation);
+    int landing_y = BOARD_HEIGHT;
+
+    /* Each column's lowest block must stay above that column's stack top */
+    for (int i = 0; i < 4; i++) {
+        if (info->bottom[i] < 0) {
+            continue;
         }
 
-        /* Check collision with existing blocks */
-        if (board->cells[block_y][block_x] != 0) {
-            return true;
+        int column = x + i;
+        if (column < 0 || column >= BOARD_WIDTH) {
+            return y;  /* Not a valid position */
+        }
+
+        int limit = BOARD_HEIGHT - board->heights[column] - 1 - info->bottom[i];
+        if (limit < landing_y) {
+            landing_y = limit;
         }
     }
 
-    return false;
+    /* Stack tops above the piece mean it sits under an overhang: scan */
+    if (landing_y < y) {
+        landing_y = y;
+        while (!board_collides(board, info, x, landing_y + 1)) {
+            landing_y++;
+        }
+    }
+
+    return landing_y;
 }
 
 /* Lock piece into board grid */
@@ -54,49 +156,436 @@ void board_lock_piece(Board* board, PieceType type,
         /* Only lock blocks within board boundaries */
         if (block_x >= 0 && block_x < BOARD_WIDTH &&
             block_y >= 0 && block_y < BOARD_HEIGHT) {
-            board->cells[block_y][block_x] = color;
+            board->rows[block_y] |= (board_row_t)(1u << block_x);
+            board->cells[block_y][block_x] = (uint8_t)color;
+
+            if (board->heights[block_x] < BOARD_HEIGHT - block_y) {
+                board->heights[block_x] = (uint8_t)(BOARD_HEIGHT - block_y);
+            }
         }
     }
 }
 
-/* Clear completed lines and shift rows down */
+/* Clear completed lines and compact the survivors in one pass */
+board_rowset_t board_clear_lines_mask(Board* board) {
+    board_rowset_t cleared = 0;
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        cleared |= (board_rowset_t)(board->rows[y] == BOARD_FULL_ROW) << y;
+    }
+    if (cleared == 0) {
+        return 0;
+    }
+
+    /* Rows above the stack are already empty and never move */
+    int top = 0;
+    while (board->rows[top] == 0) {
+        top++;
+    }
+
+    /* Move each surviving row straight to its final slot, bottom-up.
+     * Fixed-size row copies inline; per-run memmoves cost more than they
+     * save on a 20-row board */
+    int dest = BOARD_HEIGHT - 1;
+    for (int y = BOARD_HEIGHT - 1; y >= top; y--) {
+        if (cleared & ((board_rowset_t)1 << y)) {
+            continue;
+        }
+        if (dest != y) {
+            board->rows[dest] = board->rows[y];
+            memcpy(board->cells[dest], board->cells[y], BOARD_WIDTH);
+        }
+        dest--;
+    }
+    for (; dest >= top; dest--) {
+        board->rows[dest] = 0;
+        memset(board->cells[dest], 0, BOARD_WIDTH);
+    }
+
+    recompute_heights(board);
+    return cleared;
+}
+
+/* Push garbage rows in from the bottom */
+bool board_push_garbage(Board* board, int rows, int hole_x) {
+    if (rows <= 0) {
+        return true;
+    }
+    if (rows > BOARD_HEIGHT) {
+        rows = BOARD_HEIGHT;
+    }
+    if (hole_x < 0) {
+        hole_x = 0;
+    } else if (hole_x >= BOARD_WIDTH) {
+        hole_x = BOARD_WIDTH - 1;
+    }
+
+    /* Rows about to leave through the top */
+    uint32_t lost = 0;
+    for (int y = 0; y < rows; y++) {
+        lost |= board->rows[y];
+    }
+
+    int kept = BOARD_HEIGHT - rows;
+    memmove(&board->rows[0], &board->rows[rows], (size_t)kept * sizeof(board->rows[0]));
+    memmove(&board->cells[0], &board->cells[rows], (size_t)kept * sizeof(board->cells[0]));
+
+    board_row_t garbage = (board_row_t)(BOARD_FULL_ROW & ~(1u << hole_x));
+    for (int y = kept; y < BOARD_HEIGHT; y++) {
+        board->rows[y] = garbage;
+        memset(board->cells[y], BOARD_GARBAGE_COLOR, BOARD_WIDTH);
+        board->cells[y][hole_x] = 0;
+    }
+
+    /* Every column rises by rows; empty ones now top out at the garbage
+     * (except the hole column) */
+    if (lost != 0) {
+        recompute_heights(board);
+        return false;
+    }
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+        if (board->heights[x] > 0) {
+            board->heights[x] = (uint8_t)(board->heights[x] + rows);
+        } else if (x != hole_x) {
+            board->heights[x] = (uint8_t)rows;
+        }
+    }
+    return true;
+}
+
+/* Clear completed lines */
 int board_clear_lines(Board* board) {
-    int lines_cleared = 0;
+    return BOARD_ROWSET_COUNT(board_clear_lines_mask(board));
+}
+
+/* Compute heuristic features from the row masks */
+void board_features(const Board* board, BoardFeatures* features) {
+    const uint32_t full = BOARD_FULL_ROW;
+    const uint32_t right_wall = 1u << (BOARD_WIDTH - 1);
+    uint32_t covered = 0;  /* Columns with a filled cell at or above y */
+    uint32_t above = 0;    /* Row above y (empty above the board) */
+    int holes = 0;
+    int row_transitions = 0;
+    int column_transitions = 0;
+    int wells = 0;
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        uint32_t row = board->rows[y];
+
+        /* Holes: empty cells in columns already covered from above */
+        holes += __builtin_popcount(covered & ~row);
+
+        /* Wells: uncovered empty cells whose left and right neighbors
+         * are filled (walls count as filled) */
+        uint32_t left = (row << 1) | 1u;
+        uint32_t right = (row >> 1) | right_wall;
+        wells += __builtin_popcount(~(row | covered) & left & right & full);
+
+        /* Row transitions: bordered by filled walls on both sides */
+        uint32_t framed = (row << 1) | 1u | (1u << (BOARD_WIDTH + 1));
+        row_transitions += __builtin_popcount((framed ^ (framed >> 1)) &
+                                              ((full << 1) | 1u));
+
+        /* Column transitions against the row above (not the open top) */
+        if (y > 0) {
+            column_transitions += __builtin_popcount(row ^ above);
+        }
+
+        covered |= row;
+        above = row;
+    }
+    column_transitions += __builtin_popcount(above ^ full);  /* Floor */
+
+    /* Height features from the cached column heights */
+    int aggregate = 0;
+    int max_height = 0;
+    int bumpiness = 0;
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+        int h = board->heights[x];
+        aggregate += h;
+        if (h > max_height) {
+            max_height = h;
+        }
+        if (x > 0) {
+            int diff = h - board->heights[x - 1];
+            bumpiness += diff < 0 ? -diff : diff;
+        }
+    }
+
+    features->aggregate_height = aggregate;
+    features->max_height = max_height;
+    features->holes = holes;
+    features->bumpiness = bumpiness;
+    features->row_transitions = row_transitions;
+    features->column_transitions = column_transitions;
+    features->wells = wells;
+}
+
+/* Filled test for the scalar reference (walls and floor count as filled) */
+static bool scalar_filled(const Board* board, int x, int y) {
+    if (x < 0 || x >= BOARD_WIDTH || y >= BOARD_HEIGHT) {
+        return true;
+    }
+    return board->cells[y][x] != 0;
+}
+
+/* Compute heuristic features one cell at a time */
+void board_features_scalar(const Board* board, BoardFeatures* features) {
+    int heights[BOARD_WIDTH];
+
+    features->aggregate_height = 0;
+    features->max_height = 0;
+    features->holes = 0;
+    features->bumpiness = 0;
+    features->row_transitions = 0;
+    features->column_transitions = 0;
+    features->wells = 0;
+
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+        heights[x] = 0;
+        for (int y = 0; y < BOARD_HEIGHT; y++) {
+            if (board->cells[y][x] != 0) {
+                heights[x] = BOARD_HEIGHT - y;
+                break;
+            }
+        }
+
+        features->aggregate_height += heights[x];
+        if (heights[x] > features->max_height) {
+            features->max_height = heights[x];
+        }
+        if (x > 0) {
+            int diff = heights[x] - heights[x - 1];
+            features->bumpiness += diff < 0 ? -diff : diff;
+        }
+    }
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            bool filled = scalar_filled(board, x, y);
+            bool open = y < BOARD_HEIGHT - heights[x];  /* Above stack top */
+
+            if (!filled && !open) {
+                features->holes++;
+            }
+            if (!filled && open && scalar_filled(board, x - 1, y) &&
+                scalar_filled(board, x + 1, y)) {
+                features->wells++;
+            }
+            if (filled != scalar_filled(board, x - 1, y)) {
+                features->row_transitions++;
+            }
+            if (filled != scalar_filled(board, x, y + 1)) {
+                features->column_transitions++;
+            }
+        }
+
+        /* Right wall */
+        if (!scalar_filled(board, BOARD_WIDTH - 1, y)) {
+            features->row_transitions++;
+        }
+    }
+}
+
+/* Check collision one block at a time against the color plane */
+bool board_check_collision_scalar(const Board* board, PieceType type,
+                                  RotationState rotation, int x, int y) {
+    const PieceShape* shape = piece_get_shape(type, rotation);
+
+    for (int i = 0; i < 4; i++) {
+        int block_x = x + shape->cells[i][0];
+        int block_y = y + shape->cells[i][1];
+
+        if (block_x < 0 || block_x >= BOARD_WIDTH || block_y >= BOARD_HEIGHT) {
+            return true;
+        }
+        if (block_y >= 0 && board->cells[block_y][block_x] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Clear full rows of the color plane one at a time, shifting everything
+ * above down a row each, then rebuild row masks and heights from it */
+int board_clear_lines_scalar(Board* board) {
+    int cleared = 0;
 
-    /* Scan all rows from bottom to top */
     for (int y = BOARD_HEIGHT - 1; y >= 0; y--) {
-        bool line_full = true;
+        bool full = true;
+        for (int x = 0; x < BOARD_WIDTH && full; x++) {
+            full = board->cells[y][x] != 0;
+        }
+        if (!full) {
+            continue;
+        }
+
+        for (int row = y; row > 0; row--) {
+            for (int x = 0; x < BOARD_WIDTH; x++) {
+                board->cells[row][x] = board->cells[row - 1][x];
+            }
+        }
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            board->cells[0][x] = 0;
+        }
+        cleared++;
+        y++;  /* Check the row that moved into place */
+    }
 
-        /* Check if row is completely filled */
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        board->rows[y] = 0;
         for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (board->cells[y][x] == 0) {
-                line_full = false;
+            if (board->cells[y][x] != 0) {
+                board->rows[y] |= (board_row_t)(1u << x);
+            }
+        }
+    }
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+        board->heights[x] = 0;
+        for (int y = BOARD_HEIGHT - 1; y >= 0; y--) {
+            if (board->cells[y][x] != 0) {
+                board->heights[x] = (uint8_t)(BOARD_HEIGHT - y);
+            }
+        }
+    }
+
+    return cleared;
+}
+
+/* Search bounds for board_enumerate_placements: a piece's grid can hang
+ * up to 3 columns past the left wall and kick up to 4 rows above the top */
+#define SEARCH_X_OFFSET 3
+#define SEARCH_Y_OFFSET 4
+#define SEARCH_COLUMNS (BOARD_WIDTH + SEARCH_X_OFFSET)
+#define SEARCH_ROWS (BOARD_HEIGHT + SEARCH_Y_OFFSET)
+
+/* One search state (position of the piece grid and rotation) */
+typedef struct {
+    int8_t x;
+    int8_t y;
+    uint8_t rotation;
+} SearchNode;
+
+/* Footprint of a rotation with its bounding box moved to the origin */
+static uint16_t normalized_shape(const PieceInfo* info) {
+    uint16_t shape = 0;
+    for (int i = info->min_y; i <= info->max_y; i++) {
+        shape = (uint16_t)((shape << 4) | (info->rows[i] >> info->min_x));
+    }
+    return shape;
+}
+
+/* Enumerate all reachable resting positions of a piece */
+int board_enumerate_placements(const Board* board, PieceType type,
+                               Placement* out) {
+    const PieceInfo* infos[4];
+    const PieceKick* kicks = piece_get_kicks();
+    int canonical[4];  /* Lowest rotation with the same footprint */
+
+    for (int r = 0; r < 4; r++) {
+        infos[r] = piece_get_info(type, (RotationState)r);
+        canonical[r] = r;
+        for (int c = 0; c < r; c++) {
+            if (normalized_shape(infos[c]) == normalized_shape(infos[r])) {
+                canonical[r] = c;
                 break;
             }
         }
+    }
+
+    if (board_collides(board, infos[ROT_0], BOARD_SPAWN_X, BOARD_SPAWN_Y)) {
+        return 0;
+    }
+
+    /* visited: bit x+SEARCH_X_OFFSET per state; placed: bit of the
+     * footprint's left column per (canonical rotation, footprint top) */
+    uint32_t visited[4][SEARCH_ROWS];
+    uint32_t placed[4][SEARCH_ROWS];
+    SearchNode queue[4 * SEARCH_COLUMNS * SEARCH_ROWS];
+    int head = 0;
+    int tail = 0;
+    int count = 0;
 
-        /* If row is full, clear it and shift rows down */
-        if (line_full) {
-            lines_cleared++;
+    memset(visited, 0, sizeof(visited));
+    memset(placed, 0, sizeof(placed));
 
-            /* Shift all rows above this one down by one */
-            for (int shift_y = y; shift_y > 0; shift_y--) {
-                for (int x = 0; x < BOARD_WIDTH; x++) {
-                    board->cells[shift_y][x] = board->cells[shift_y - 1][x];
-                }
+    queue[tail++] = (SearchNode){BOARD_SPAWN_X, BOARD_SPAWN_Y, ROT_0};
+    visited[ROT_0][BOARD_SPAWN_Y + SEARCH_Y_OFFSET] |=
+        1u << (BOARD_SPAWN_X + SEARCH_X_OFFSET);
+
+    while (head < tail) {
+        SearchNode node = queue[head++];
+        const PieceInfo* info = infos[node.rotation];
+        SearchNode next[4];
+        int num_next = 0;
+
+        /* Resting position: cannot move down (record once per footprint) */
+        if (board_collides(board, info, node.x, node.y + 1)) {
+            int c = canonical[node.rotation];
+            int top = node.y + info->min_y + SEARCH_Y_OFFSET;
+            uint32_t bit = 1u << (node.x + info->min_x);
+            if ((placed[c][top] & bit) == 0) {
+                placed[c][top] |= bit;
+                out[count++] = (Placement){node.x, node.y,
+                                           (RotationState)node.rotation};
             }
+        } else {
+            next[num_next++] = (SearchNode){node.x, (int8_t)(node.y + 1),
+                                            node.rotation};
+        }
 
-            /* Clear top row */
-            for (int x = 0; x < BOARD_WIDTH; x++) {
-                board->cells[0][x] = 0;
+        if (!board_collides(board, info, node.x - 1, node.y)) {
+            next[num_next++] = (SearchNode){(int8_t)(node.x - 1), node.y,
+                                            node.rotation};
+        }
+        if (!board_collides(board, info, node.x + 1, node.y)) {
+            next[num_next++] = (SearchNode){(int8_t)(node.x + 1), node.y,
+                                            node.rotation};
+        }
+
+        /* Rotation takes the first free kick, exactly like game_rotate */
+        int rotation = piece_rotate_cw((RotationState)node.rotation);
+        for (int i = 0; i < PIECE_KICK_COUNT; i++) {
+            int x = node.x + kicks[i].dx;
+            int y = node.y + kicks[i].dy;
+            if (!board_collides(board, infos[rotation], x, y)) {
+                next[num_next++] = (SearchNode){(int8_t)x, (int8_t)y,
+                                                (uint8_t)rotation};
+                break;
             }
+        }
 
-            /* Re-check same row (since we shifted down) */
-            y++;
+        for (int i = 0; i < num_next; i++) {
+            int row = next[i].y + SEARCH_Y_OFFSET;
+            if (row < 0) {
+                continue;  /* Kicked above the search window */
+            }
+            uint32_t bit = 1u << (next[i].x + SEARCH_X_OFFSET);
+            if ((visited[next[i].rotation][row] & bit) == 0) {
+                visited[next[i].rotation][row] |= bit;
+                queue[tail++] = next[i];
+            }
         }
     }
 
-    return lines_cleared;
+    return count;
+}
+
+/* Enumerate placements into arena memory */
+Placement* board_enumerate_placements_arena(const Board* board, PieceType type,
+                                            Arena* arena, int* count) {
+    Placement* out = (Placement*)arena_alloc(arena,
+                                             BOARD_MAX_PLACEMENTS * sizeof(Placement),
+                                             ARENA_DEFAULT_ALIGN);
+    if (out == NULL) {
+        *count = 0;
+        return NULL;
+    }
+
+    /* Give back the unused tail of the worst-case block */
+    *count = board_enumerate_placements(board, type, out);
+    arena_rewind(arena, (size_t)((uint8_t*)(out + *count) - arena->base));
+    return out;
 }
 
 /* Get cell value at position */
@@ -111,21 +600,10 @@ int board_get_cell(const Board* board, int x, int y) {
 
 /* Check if spawn position is blocked */
 bool board_is_spawn_blocked(const Board* board) {
-    /* Standard spawn position is top-center (x=3, y=0) for most pieces
-     * Check a few cells at the top-center area */
-    const int spawn_x = BOARD_WIDTH / 2 - 1;  /* x=4 for 10-wide board */
-    const int spawn_y = 0;
-
-    /* Check 4-cell spawn area at top-center */
-    for (int x = spawn_x; x < spawn_x + 2; x++) {
-        for (int y = spawn_y; y < spawn_y + 2; y++) {
-            if (x >= 0 && x < BOARD_WIDTH && y >= 0 && y < BOARD_HEIGHT) {
-                if (board->cells[y][x] != 0) {
-                    return true;
-                }
-            }
-        }
-    }
+    /* Check the 2x2 cell area at the center of the spawn grid
+     * (x=4-5, y=0-1 on a 10-wide board) */
+    const uint32_t spawn_mask = 0x3u << (BOARD_SPAWN_X + 1);
 
-    return false;
+    return ((board->rows[BOARD_SPAWN_Y] | board->rows[BOARD_SPAWN_Y + 1]) &
+            spawn_mask) != 0;
 }
@@ -2,25 +2,122 @@
 #define BOARD_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
 #include "piece.h"
 
-/* Game board dimensions */
+/* Game board dimensions (10x20 unless the build overrides them, e.g.
+ * -DBOARD_WIDTH=12; see "make variants"). Everything sized by them is
+ * fixed at compile time, so each variant is its own specialized build */
+#ifndef BOARD_WIDTH
 #define BOARD_WIDTH 10
+#endif
+#ifndef BOARD_HEIGHT
 #define BOARD_HEIGHT 20
+#endif
 
-/* Board grid structure (10x20 cells) */
+/* Row masks plus the wall bits of board_features and the search window
+ * of board_enumerate_placements must fit in 32 bits; row sets in 64 */
+#if BOARD_WIDTH < 4 || BOARD_WIDTH > 28
+#error "BOARD_WIDTH must be between 4 and 28"
+#endif
+#if BOARD_HEIGHT < 4 || BOARD_HEIGHT > 64
+#error "BOARD_HEIGHT must be between 4 and 64"
+#endif
+
+/* Occupancy mask of one row: the narrowest type holding BOARD_WIDTH bits */
+#if BOARD_WIDTH <= 16
+typedef uint16_t board_row_t;
+#else
+typedef uint32_t board_row_t;
+#endif
+
+/* Set of rows (bit y = row y), e.g. the rows cleared by one lock */
+#if BOARD_HEIGHT <= 32
+typedef uint32_t board_rowset_t;
+#define BOARD_ROWSET_COUNT(set) __builtin_popcount(set)
+#else
+typedef uint64_t board_rowset_t;
+#define BOARD_ROWSET_COUNT(set) __builtin_popcountll(set)
+#endif
+
+/* Spawn position of a new piece (top-left of its 4x4 grid, centered) */
+#define BOARD_SPAWN_X (BOARD_WIDTH / 2 - 2)
+#define BOARD_SPAWN_Y 0
+
+/* Bytes holding one occupancy bit per cell (see board_pack) */
+#define BOARD_PACKED_BYTES ((BOARD_WIDTH * BOARD_HEIGHT + 7) / 8)
+
+/* Color given to cells rebuilt from occupancy alone (board_load_rows) */
+#define BOARD_GARBAGE_COLOR 8
+
+/* Row occupancy mask with every column filled (0x3FF for 10 columns) */
+#define BOARD_FULL_ROW ((board_row_t)((1u << BOARD_WIDTH) - 1))
+
+/* Board grid structure (BOARD_WIDTH x BOARD_HEIGHT cells)
+ * rows[] is the occupancy layer used for collision and line detection
+ * (bit x of rows[y] set when cell {x, y} is filled); cells[] holds the
+ * matching colors for rendering. Both planes are always kept in sync.
+ * heights[] caches each column's stack height (rows from the floor up to
+ * and including its topmost filled cell, 0 if empty). */
 typedef struct {
-    int cells[BOARD_HEIGHT][BOARD_WIDTH];  /* 0 = empty, 1-7 = piece color */
+    board_row_t rows[BOARD_HEIGHT];            /* Occupancy bitmask per row */
+    uint8_t cells[BOARD_HEIGHT][BOARD_WIDTH];  /* 0 = empty, 1-8 = cell color */
+    uint8_t heights[BOARD_WIDTH];              /* Column stack heights */
 } Board;
 
+/* Final resting position of a piece (see board_enumerate_placements) */
+typedef struct {
+    int x;                   /* Grid position, as for board_lock_piece */
+    int y;
+    RotationState rotation;
+} Placement;
+
+/* Heuristic features of a board position (see board_features) */
+typedef struct {
+    int aggregate_height;    /* Sum of column heights */
+    int max_height;          /* Tallest column */
+    int holes;               /* Empty cells with a filled cell above */
+    int bumpiness;           /* Sum of height differences of adjacent columns */
+    int row_transitions;     /* Filled/empty changes along rows (walls filled) */
+    int column_transitions;  /* Filled/empty changes down columns (floor filled) */
+    int wells;               /* Open empty cells with both neighbors filled
+                              * (walls filled), i.e. summed well depths */
+} BoardFeatures;
+
+/* Upper bound on placements returned for one piece (one per search state) */
+#define BOARD_MAX_PLACEMENTS (4 * (BOARD_WIDTH + 3) * (BOARD_HEIGHT + 4))
+
 /* Initialize board to empty state (all cells = 0) */
 void board_init(Board* board);
 
+/* Replace board contents with the given row masks (BOARD_HEIGHT entries)
+ * Filled cells get BOARD_GARBAGE_COLOR; heights are rebuilt */
+void board_load_rows(Board* board, const board_row_t* rows);
+
+/* Pack occupancy into BOARD_PACKED_BYTES bytes, bit y * BOARD_WIDTH + x
+ * (colors are dropped) */
+void board_pack(const Board* board, uint8_t* out);
+
+/* Rebuild board from board_pack output (cells get BOARD_GARBAGE_COLOR) */
+void board_unpack(Board* board, const uint8_t* in);
+
 /* Check if piece would collide with board or boundaries
  * Returns true if collision detected, false if position is valid */
 bool board_check_collision(const Board* board, PieceType type,
                            RotationState rotation, int x, int y);
 
+/* Same test from precomputed piece data (see piece_get_info)
+ * Out-of-bounds positions are rejected from the bounding box alone,
+ * without touching the board */
+bool board_collides(const Board* board, const PieceInfo* info, int x, int y);
+
+/* Get landing row of a piece dropped straight down from a valid position
+ * (the lowest y' >= y without collision). Computed from column heights in
+ * O(4); falls back to a scan when the piece is tucked under an overhang */
+int board_drop_y(const Board* board, PieceType type,
+                 RotationState rotation, int x, int y);
+
 /* Lock piece into board grid at given position
  * Writes piece color to all 4 block positions */
 void board_lock_piece(Board* board, PieceType type,
@@ -30,12 +127,60 @@ void board_lock_piece(Board* board, PieceType type,
  * Returns number of lines cleared (0-4) */
 int board_clear_lines(Board* board);
 
+/* Same, returning the cleared rows as a bitmask (bit y set if row y, as
+ * numbered before the clear, was full). Full rows are found first, then
+ * each surviving row is copied down exactly once */
+board_rowset_t board_clear_lines_mask(Board* board);
+
+/* Push rows of garbage in from the bottom (versus play): the stack moves
+ * up by rows, and each new bottom row is full except for column hole_x
+ * (clamped to 0..BOARD_WIDTH-1). Row masks, colors and heights all move
+ * as whole rows
+ * Returns false if filled cells were pushed out through the top */
+bool board_push_garbage(Board* board, int rows, int hole_x);
+
+/* Find every position where a piece spawned at BOARD_SPAWN_X/Y can come
+ * to rest, by a breadth-first search over (x, y, rotation) using moves
+ * left, right, down and clockwise rotation with the same wall kicks as
+ * game_rotate. Positions that fill the same cells (e.g. O-piece
+ * rotations) are reported once, in the first rotation found.
+ * out must hold BOARD_MAX_PLACEMENTS entries
+ * Returns number of placements written (0 if the spawn is blocked) */
+int board_enumerate_placements(const Board* board, PieceType type,
+                               Placement* out);
+
+/* Same search with the result allocated from an arena, trimmed to the
+ * number of placements found (the arena needs room for
+ * BOARD_MAX_PLACEMENTS while searching)
+ * Returns the list and sets *count, or NULL with *count = 0 if the arena
+ * is full */
+Placement* board_enumerate_placements_arena(const Board* board, PieceType type,
+                                            Arena* arena, int* count);
+
+/* Compute all heuristic features in one top-down pass over the row
+ * masks, handling every column of a row with a few word operations */
+void board_features(const Board* board, BoardFeatures* features);
+
+/* Reference implementation of board_features over the color plane,
+ * one cell at a time (for testing the bit-parallel version) */
+void board_features_scalar(const Board* board, BoardFeatures* features);
+
+/* Reference implementations of board_check_collision and
+ * board_clear_lines over the color plane, one cell at a time (for the
+ * differential checks in the benchmark suite). The clear rebuilds row
+ * masks and heights from the cells, so the whole Board must match */
+bool board_check_collision_scalar(const Board* board, PieceType type,
+                                  RotationState rotation, int x, int y);
+int board_clear_lines_scalar(Board* board);
+
 /* Get cell value at position (for rendering)
- * Returns 0 if empty, 1-7 for piece color
+ * Returns 0 if empty, 1-7 for piece color, BOARD_GARBAGE_COLOR for cells
+ * restored from row masks
  * Returns 0 for out-of-bounds coordinates */
 int board_get_cell(const Board* board, int x, int y);
 
-/* Check if spawn position (top-center) is blocked
+/* Check if spawn position (top-center) is blocked: the 2x2 area at the
+ * center of the spawn grid, which every piece covers part of
  * Returns true if spawn position overlaps existing blocks */
 bool board_is_spawn_blocked(const Board* board);
 
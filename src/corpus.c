@@ -0,0 +1,164 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "corpus.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CORPUS_MAGIC "NTRC"
+
+/* Records are read in place from the mapping, right after the header */
+typedef char corpus_record_alignment_check[CORPUS_HEADER_SIZE % sizeof(uint32_t) == 0 &&
+                                           sizeof(CorpusRecord) % sizeof(uint32_t) == 0
+                                           ? 1 : -1];
+
+/* Build the file header */
+static void make_header(uint8_t* header) {
+    uint16_t version = CORPUS_VERSION;
+    uint16_t record_size = (uint16_t)sizeof(CorpusRecord);
+
+    memset(header, 0, CORPUS_HEADER_SIZE);
+    memcpy(header, CORPUS_MAGIC, 4);
+    memcpy(header + 4, &version, sizeof(version));
+    memcpy(header + 6, &record_size, sizeof(record_size));
+
+    /* Other board sizes tag their files (10x20 headers keep zeros here) */
+    if (BOARD_WIDTH != 10 || BOARD_HEIGHT != 20) {
+        header[8] = BOARD_WIDTH;
+        header[9] = BOARD_HEIGHT;
+    }
+}
+
+/* Open for appending */
+bool corpus_writer_open(CorpusWriter* writer, const char* path) {
+    uint8_t header[CORPUS_HEADER_SIZE];
+    make_header(header);
+
+    writer->file = fopen(path, "a+b");
+    if (writer->file == NULL) {
+        return false;
+    }
+    setvbuf(writer->file, writer->buffer, _IOFBF, sizeof(writer->buffer));
+
+    /* New file: write header; existing file: it must be a matching corpus */
+    uint8_t existing[CORPUS_HEADER_SIZE];
+    size_t got = fread(existing, 1, sizeof(existing), writer->file);
+    bool ok;
+    if (got == 0) {
+        ok = fwrite(header, 1, sizeof(header), writer->file) == sizeof(header) &&
+             fflush(writer->file) == 0;
+    } else {
+        ok = got == sizeof(existing) && memcmp(existing, header, sizeof(header)) == 0;
+    }
+
+    /* Drop a record cut short by a crash, so appends stay aligned */
+    struct stat st;
+    int fd = fileno(writer->file);
+    off_t records = 0;
+    ok = ok && fstat(fd, &st) == 0;
+    if (ok) {
+        records = (st.st_size - CORPUS_HEADER_SIZE) / (off_t)sizeof(CorpusRecord);
+        off_t aligned = CORPUS_HEADER_SIZE + records * (off_t)sizeof(CorpusRecord);
+        ok = aligned == st.st_size || ftruncate(fd, aligned) == 0;
+    }
+
+    /* Number new games after the last one in the file */
+    writer->game_id = 0;
+    if (ok && records > 0) {
+        uint32_t last_id = 0;
+        ok = fseek(writer->file, CORPUS_HEADER_SIZE + (records - 1) *
+                                     (off_t)sizeof(CorpusRecord), SEEK_SET) == 0 &&
+             fread(&last_id, sizeof(last_id), 1, writer->file) == 1;
+        writer->game_id = last_id + 1;
+    }
+
+    /* Switching from reading to appending needs a positioning call */
+    ok = ok && fseek(writer->file, 0, SEEK_END) == 0;
+    if (!ok) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return false;
+    }
+
+    writer->failed = false;
+    return true;
+}
+
+/* Append one record */
+void corpus_writer_append(CorpusWriter* writer, const CorpusRecord* record) {
+    if (fwrite(record, sizeof(*record), 1, writer->file) != 1) {
+        writer->failed = true;
+    }
+}
+
+/* Flush and close */
+bool corpus_writer_close(CorpusWriter* writer) {
+    if (fclose(writer->file) != 0) {
+        writer->failed = true;
+    }
+    writer->file = NULL;
+    return !writer->failed;
+}
+
+/* Record a locked piece */
+void corpus_lock_hook(const Game* game, const GameLockEvent* event, void* ctx) {
+    CorpusWriter* writer = (CorpusWriter*)ctx;
+    CorpusRecord record;
+    (void)game;
+
+    memset(&record, 0, sizeof(record));
+    record.game_id = writer->game_id;
+    record.score_delta = event->score_delta;
+    board_pack(event->board, record.cells);
+    record.piece = (uint8_t)event->piece;
+    record.next_piece = (uint8_t)event->next_piece;
+    record.rotation = (uint8_t)event->rotation;
+    record.x = (int8_t)event->x;
+    record.y = (int8_t)event->y;
+    record.lines = (uint8_t)event->lines;
+    corpus_writer_append(writer, &record);
+}
+
+/* Map a corpus read-only */
+bool corpus_open(CorpusReader* reader, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < CORPUS_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+
+    reader->map_size = (size_t)st.st_size;
+    reader->map = mmap(NULL, reader->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* The mapping keeps the file referenced */
+    if (reader->map == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t header[CORPUS_HEADER_SIZE];
+    make_header(header);
+    if (memcmp(reader->map, header, sizeof(header)) != 0) {
+        munmap(reader->map, reader->map_size);
+        return false;
+    }
+
+    /* A trailing partial record (interrupted append) is not counted */
+    reader->records = (const CorpusRecord*)((const uint8_t*)reader->map +
+                                            CORPUS_HEADER_SIZE);
+    reader->count = (reader->map_size - CORPUS_HEADER_SIZE) / sizeof(CorpusRecord);
+    return true;
+}
+
+/* Unmap a corpus */
+void corpus_close(CorpusReader* reader) {
+    munmap(reader->map, reader->map_size);
+    reader->map = NULL;
+    reader->records = NULL;
+    reader->count = 0;
+}
@@ -0,0 +1,111 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "game.h"
+
+/**
+ * corpus.h - Append-only training corpus of piece placements
+ *
+ * One fixed-size record per locked piece: the board before the lock, the
+ * piece and preview, the chosen placement and the points it scored. After
+ * a 16-byte header the file is a plain array of CorpusRecord, so a reader
+ * mmaps it and walks the records in place with no parsing or copying.
+ * Records are appended with buffered stdio; a record cut short by a crash
+ * is ignored by readers and dropped when the file is next opened for
+ * appending. Fields are in host byte order.
+ *
+ * Records are produced by corpus_lock_hook, installed on headless games
+ * with game_set_lock_hook (ntris --replay FILE --corpus FILE does this
+ * for a recorded session).
+ */
+
+#define CORPUS_VERSION 1
+#define CORPUS_HEADER_SIZE 16
+#define CORPUS_BUFFER_SIZE 65536  /* stdio buffer for appending */
+
+/* One locked piece */
+typedef struct {
+    uint32_t game_id;                   /* CorpusWriter.game_id at lock time */
+    int32_t score_delta;                /* Points awarded for the lock */
+    uint8_t cells[BOARD_PACKED_BYTES];  /* Board before the lock (board_pack) */
+    uint8_t piece;                      /* PieceType */
+    uint8_t next_piece;                 /* Preview at lock time */
+    uint8_t rotation;                   /* Chosen placement */
+    int8_t x;
+    int8_t y;
+    uint8_t lines;                      /* Lines cleared (0-4) */
+    uint8_t reserved[5];                /* Zero (pads the record to a multiple
+                                         * of 4 bytes, 44 on 10x20) */
+} CorpusRecord;
+
+/* Appending writer (one per thread) */
+typedef struct {
+    FILE* file;
+    uint32_t game_id;  /* Tag stored in each record: one past the file's
+                        * last game on open, then set by the caller */
+    bool failed;       /* A write failed */
+    char buffer[CORPUS_BUFFER_SIZE];
+} CorpusWriter;
+
+/* Read-only mapping of a corpus file */
+typedef struct {
+    const CorpusRecord* records;
+    size_t count;
+    void* map;
+    size_t map_size;
+} CorpusReader;
+
+/**
+ * Open a corpus for appending, writing the header if the file is new.
+ * game_id is set one past the last record's, so a new game gets its own.
+ *
+ * @param writer Pointer to writer structure
+ * @param path Corpus file (created if missing)
+ * @return false if the file cannot be opened or is not a corpus
+ */
+bool corpus_writer_open(CorpusWriter* writer, const char* path);
+
+/**
+ * Append one record.
+ *
+ * @param writer Pointer to open writer
+ * @param record Record to append
+ */
+void corpus_writer_append(CorpusWriter* writer, const CorpusRecord* record);
+
+/**
+ * Flush and close.
+ *
+ * @param writer Pointer to open writer
+ * @return true if every record was written successfully
+ */
+bool corpus_writer_close(CorpusWriter* writer);
+
+/**
+ * Lock hook that appends a record per locked piece. Pass the writer as
+ * ctx and ask for the board: game_set_lock_hook(game, corpus_lock_hook,
+ * writer, true).
+ */
+void corpus_lock_hook(const Game* game, const GameLockEvent* event, void* ctx);
+
+/**
+ * Map a corpus read-only.
+ *
+ * @param reader Pointer to reader structure
+ * @param path Corpus file
+ * @return false if the file cannot be mapped or is not a corpus
+ */
+bool corpus_open(CorpusReader* reader, const char* path);
+
+/**
+ * Unmap a corpus.
+ *
+ * @param reader Pointer to open reader
+ */
+void corpus_close(CorpusReader* reader);
+
+#endif /* CORPUS_H */
@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "event.h"
+#include <poll.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Nanoseconds per second */
+#define NSEC_PER_SEC 1000000000L
+
+/**
+ * Initialize event loop (create non-blocking monotonic timerfd).
+ */
+bool event_init(EventLoop* events, int input_fd) {
+    events->input_fd = input_fd;
+    events->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    return events->timer_fd >= 0;
+}
+
+/**
+ * Arm timerfd for a relative timeout, or disarm it if timeout < 0.
+ */
+static void arm_timer(EventLoop* events, double timeout) {
+    struct itimerspec spec = {{0, 0}, {0, 0}};
+
+    if (timeout >= 0.0) {
+        spec.it_value.tv_sec = (time_t)timeout;
+        spec.it_value.tv_nsec = (long)((timeout - (double)spec.it_value.tv_sec) * NSEC_PER_SEC);
+
+        /* A zero it_value disarms the timer; expire immediately instead */
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+
+    timerfd_settime(events->timer_fd, 0, &spec, NULL);
+}
+
+/**
+ * Sleep until input is available or the timeout expires.
+ */
+int event_wait(EventLoop* events, double timeout) {
+    struct pollfd fds[2];
+    fds[0].fd = events->input_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = events->timer_fd;
+    fds[1].events = POLLIN;
+
+    arm_timer(events, timeout);
+
+    int result = 0;
+    if (poll(fds, 2, -1) > 0) {
+        if (fds[0].revents & POLLIN) {
+            result |= EVENT_INPUT;
+        }
+        if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL)) {
+            result |= EVENT_HANGUP;
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(events->timer_fd, &expirations, sizeof(expirations)) > 0) {
+                result |= EVENT_TIMER;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Release event loop resources.
+ */
+void event_cleanup(EventLoop* events) {
+    if (events->timer_fd >= 0) {
+        close(events->timer_fd);
+        events->timer_fd = -1;
+    }
+}
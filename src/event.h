@@ -0,0 +1,53 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdbool.h>
+
+/**
+ * event.h - Blocking wait on keyboard input or a timer deadline
+ *
+ * Backs the event-driven main loop: instead of waking every frame, the
+ * loop sleeps in poll() on the terminal input descriptor and a timerfd
+ * armed for the game's next gravity or lock-delay deadline. With no
+ * deadline (start screen, paused, game over) it sleeps until a key
+ * arrives, so idle sessions use no CPU.
+ */
+
+/* Bits returned by event_wait */
+#define EVENT_INPUT 0x1  /* Input descriptor is readable */
+#define EVENT_TIMER 0x2  /* Deadline expired */
+#define EVENT_HANGUP 0x4 /* Input hung up or failed: no more keys will come */
+
+typedef struct {
+    int input_fd;  /* Terminal input (usually STDIN_FILENO) */
+    int timer_fd;  /* timerfd used for deadlines */
+} EventLoop;
+
+/**
+ * Initialize event loop.
+ *
+ * @param events Pointer to event loop structure
+ * @param input_fd Descriptor to wait on for input
+ * @return true on success, false if the timerfd could not be created
+ */
+bool event_init(EventLoop* events, int input_fd);
+
+/**
+ * Sleep until input is available or the timeout expires.
+ *
+ * @param events Pointer to initialized event loop
+ * @param timeout Seconds until deadline (< 0 waits for input only)
+ * @return Bitmask of EVENT_INPUT / EVENT_TIMER / EVENT_HANGUP (0 if
+ *         interrupted). Once EVENT_HANGUP is reported, every further
+ *         wait returns immediately with it, so the caller should stop
+ */
+int event_wait(EventLoop* events, double timeout);
+
+/**
+ * Release event loop resources.
+ *
+ * @param events Pointer to initialized event loop
+ */
+void event_cleanup(EventLoop* events);
+
+#endif /* EVENT_H */
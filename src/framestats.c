@@ -0,0 +1,109 @@
+#include "framestats.h"
+#include <string.h>
+
+#define USEC_PER_SEC 1e6
+
+static const char* const PHASE_NAMES[FRAME_PHASE_COUNT] = {
+    "input",
+    "update",
+    "render",
+    "refresh",
+    "oversleep",
+    "undersleep"
+};
+
+/* Reset all histograms */
+void frame_stats_init(FrameStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+/* Get the log2 bucket of a value */
+int frame_stats_bucket(uint64_t value, int bucket_count) {
+    int bucket = value > 0 ? 63 - __builtin_clzll(value) : 0;
+    return bucket < bucket_count ? bucket : bucket_count - 1;
+}
+
+/* Record one duration into its log2 bucket */
+void frame_stats_record(FrameStats* stats, FramePhase phase, double seconds) {
+    FrameHistogram* histogram = &stats->phases[phase];
+    if (seconds < 0.0) {
+        seconds = 0.0;
+    }
+
+    int bucket = frame_stats_bucket((uint64_t)(seconds * USEC_PER_SEC),
+                                    FRAME_STATS_BUCKETS);
+
+    histogram->count++;
+    histogram->total += seconds;
+    if (seconds > histogram->max) {
+        histogram->max = seconds;
+    }
+    histogram->buckets[bucket]++;
+}
+
+/* Mean duration */
+double frame_stats_mean(const FrameHistogram* histogram) {
+    if (histogram->count == 0) {
+        return 0.0;
+    }
+    return histogram->total / (double)histogram->count;
+}
+
+/* Upper bound of the bucket holding the given percentile */
+double frame_stats_percentile(const FrameHistogram* histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = (uint64_t)(percentile * (double)histogram->count);
+    uint64_t seen = 0;
+    for (int i = 0; i < FRAME_STATS_BUCKETS - 1; i++) {
+        seen += histogram->buckets[i];
+        if (seen > target) {
+            double top = (double)(2ull << i) / USEC_PER_SEC;
+            return top < histogram->max ? top : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/* Display name */
+const char* frame_stats_phase_name(FramePhase phase) {
+    if (phase < 0 || phase >= FRAME_PHASE_COUNT) {
+        return "invalid";
+    }
+    return PHASE_NAMES[phase];
+}
+
+/* Print summary and histograms */
+void frame_stats_dump(const FrameStats* stats, FILE* out) {
+    fprintf(out, "%-10s %10s %10s %10s %10s %10s\n",
+            "phase", "count", "mean_us", "p50_us", "p99_us", "max_us");
+
+    for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+        const FrameHistogram* histogram = &stats->phases[p];
+        fprintf(out, "%-10s %10llu %10.1f %10.1f %10.1f %10.1f\n",
+                PHASE_NAMES[p], (unsigned long long)histogram->count,
+                frame_stats_mean(histogram) * USEC_PER_SEC,
+                frame_stats_percentile(histogram, 0.50) * USEC_PER_SEC,
+                frame_stats_percentile(histogram, 0.99) * USEC_PER_SEC,
+                histogram->max * USEC_PER_SEC);
+    }
+
+    /* Bucket lines: phase, then "<lower_us>:<count>" per non-empty bucket */
+    for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+        const FrameHistogram* histogram = &stats->phases[p];
+        if (histogram->count == 0) {
+            continue;
+        }
+
+        fprintf(out, "histogram %s", PHASE_NAMES[p]);
+        for (int i = 0; i < FRAME_STATS_BUCKETS; i++) {
+            if (histogram->buckets[i] > 0) {
+                fprintf(out, " %llu:%u", i == 0 ? 0ull : 1ull << i,
+                        histogram->buckets[i]);
+            }
+        }
+        fprintf(out, "\n");
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * framestats.h - Per-phase frame timing histograms (--debug-stats)
+ *
+ * The main loop times each phase of a frame with timer_get_time and
+ * records the duration here. Each phase keeps a count, total, maximum and
+ * a log2 histogram with microsecond resolution, so outliers (a slow
+ * doupdate over SSH, a late wake-up) stay visible next to the averages.
+ */
+
+/* Histogram bucket i holds durations in [2^i, 2^(i+1)) microseconds
+ * (bucket 0 also holds anything under 1 us; the last holds the rest) */
+#define FRAME_STATS_BUCKETS 21
+
+typedef enum {
+    FRAME_PHASE_INPUT,       /* input_poll and handling */
+    FRAME_PHASE_UPDATE,      /* game_update */
+    FRAME_PHASE_RENDER,      /* Drawing into the curses windows */
+    FRAME_PHASE_REFRESH,     /* render_refresh (doupdate, terminal output) */
+    FRAME_PHASE_OVERSLEEP,   /* Woke up after the frame deadline */
+    FRAME_PHASE_UNDERSLEEP,  /* Woke up before the frame deadline */
+    FRAME_PHASE_COUNT
+} FramePhase;
+
+typedef struct {
+    uint64_t count;
+    double total;  /* Seconds */
+    double max;    /* Seconds */
+    uint32_t buckets[FRAME_STATS_BUCKETS];
+} FrameHistogram;
+
+typedef struct {
+    FrameHistogram phases[FRAME_PHASE_COUNT];
+} FrameStats;
+
+/**
+ * Reset all histograms.
+ *
+ * @param stats Pointer to stats structure
+ */
+void frame_stats_init(FrameStats* stats);
+
+/**
+ * Record one duration.
+ *
+ * @param stats Pointer to stats structure
+ * @param phase Phase measured
+ * @param seconds Duration (negative values count as 0)
+ */
+void frame_stats_record(FrameStats* stats, FramePhase phase, double seconds);
+
+/**
+ * Get the log2 histogram bucket of a value: bucket i holds [2^i, 2^(i+1))
+ * (bucket 0 also holds 0; the last bucket holds everything above).
+ *
+ * @param value Value to place (microseconds here, any unit elsewhere)
+ * @param bucket_count Number of buckets
+ */
+int frame_stats_bucket(uint64_t value, int bucket_count);
+
+/**
+ * Get mean duration of a phase in seconds (0 if never recorded).
+ */
+double frame_stats_mean(const FrameHistogram* histogram);
+
+/**
+ * Get an upper bound on the given percentile in seconds: the top of
+ * the histogram bucket containing it (0 if never recorded).
+ *
+ * @param histogram Phase histogram
+ * @param percentile Fraction in [0, 1], e.g. 0.99
+ */
+double frame_stats_percentile(const FrameHistogram* histogram, double percentile);
+
+/**
+ * Get short display name of a phase.
+ */
+const char* frame_stats_phase_name(FramePhase phase);
+
+/**
+ * Print a summary line and the non-empty buckets of every phase.
+ *
+ * @param stats Pointer to stats structure
+ * @param out Stream to write to
+ */
+void frame_stats_dump(const FrameStats* stats, FILE* out);
+
+#endif /* FRAMESTATS_H */
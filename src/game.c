@@ -1,23 +1,28 @@
 #include "game.h"
-#include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
 /* Constants */
-#define SPAWN_X 3           /* Spawn X position (left edge of piece) */
-#define SPAWN_Y 0           /* Spawn Y position (top) */
-#define LOCK_DELAY 0.5      /* Lock delay in seconds */
+#define LOCK_DELAY_FRAMES 30  /* Lock delay in frames (0.5 s at 60 FPS) */
 #define LINES_PER_LEVEL 10  /* Lines needed to advance level */
-
-/* Wall kick offsets for rotation attempts (Simple Rotation System) */
-static const int WALL_KICK_OFFSETS[][2] = {
-    {0, 0},   /* No offset */
-    {-1, 0},  /* Left 1 */
-    {1, 0},   /* Right 1 */
-    {0, -1},  /* Up 1 */
-    {-2, 0},  /* Left 2 (for I-piece) */
-    {2, 0}    /* Right 2 (for I-piece) */
-};
-#define WALL_KICK_COUNT 6
+#define SHIFT_DAS_FRAMES 16     /* Delayed auto-shift: hold time before repeating */
+#define SHIFT_ARR_FRAMES 6      /* Auto-repeat rate: frames between repeated moves */
+#define SHIFT_REPEAT_FRAMES 5   /* Max gap between terminal repeats of a held key */
+#define SHIFT_PRESS_FRAMES 40   /* Charge kept after a press awaiting the first
+                                 * terminal repeat (covers its initial delay) */
+#define GAME_DEFAULT_SEED 0x6E74726973ULL  /* Seed used by game_init */
+
+/* Snapshots must stay well within one cache line (on boards up to 10x20) */
+typedef char game_snapshot_size_check[sizeof(GameSnapshot) <= 56 ||
+                                      BOARD_PACKED_BYTES > 25 ? 1 : -1];
+
+/* A full queue (one short of a preview, plus a batch) spans at most two
+ * batches and fits the snapshot's 4-bit count; redrawing both batches
+ * behind the piece before them fits the ring */
+#define QUEUE_MAX_COUNT (GAME_PREVIEW_COUNT - 1 + PIECE_COUNT)
+typedef char game_queue_size_check[GAME_PREVIEW_COUNT - 1 <= PIECE_COUNT &&
+                                   QUEUE_MAX_COUNT <= 15 &&
+                                   1 + 2 * PIECE_COUNT <= GAME_QUEUE_SIZE
+                                   ? 1 : -1];
 
 /* Scoring multipliers for line clears */
 static const int LINE_CLEAR_SCORES[] = {
@@ -28,8 +33,130 @@ static const int LINE_CLEAR_SCORES[] = {
     800   /* 4 lines (Tetris!) */
 };
 
+#define QUEUE_MASK (GAME_QUEUE_SIZE - 1)
+
+/* Append one batch of PIECE_COUNT pieces from the game's own generator */
+static void refill_queue(Game* game) {
+    PieceQueue* queue = &game->queue;
+    uint8_t batch[PIECE_COUNT];
+
+    /* Remember where the batch came from (see game_snapshot) */
+    queue->batch_rng[0] = queue->batch_rng[1];
+    queue->batch_last[0] = queue->batch_last[1];
+    queue->batch_rng[1] = game->rng.state;
+    queue->batch_last[1] = queue->count > 0
+                               ? queue->pieces[(queue->head + queue->count - 1) & QUEUE_MASK]
+                               : PIECE_COUNT;
+
+    switch ((Randomizer)queue->randomizer) {
+    case RANDOMIZER_BAG:
+        /* Fisher-Yates shuffle of one of each piece */
+        for (int i = 0; i < PIECE_COUNT; i++) {
+            batch[i] = (uint8_t)i;
+        }
+        for (int i = PIECE_COUNT - 1; i > 0; i--) {
+            int j = (int)rng_range(&game->rng, (uint32_t)i + 1);
+            uint8_t swap = batch[i];
+            batch[i] = batch[j];
+            batch[j] = swap;
+        }
+        break;
+
+    case RANDOMIZER_NES: {
+        /* Roll 8 ways; a repeat or the 8th outcome gets one plain reroll */
+        int last = queue->count > 0
+                       ? queue->pieces[(queue->head + queue->count - 1) & QUEUE_MASK]
+                       : PIECE_COUNT;
+        for (int i = 0; i < PIECE_COUNT; i++) {
+            int piece = (int)rng_range(&game->rng, PIECE_COUNT + 1);
+            if (piece == PIECE_COUNT || piece == last) {
+                piece = (int)rng_range(&game->rng, PIECE_COUNT);
+            }
+            batch[i] = (uint8_t)piece;
+            last = piece;
+        }
+        break;
+    }
+
+    default:
+        for (int i = 0; i < PIECE_COUNT; i++) {
+            batch[i] = (uint8_t)rng_range(&game->rng, PIECE_COUNT);
+        }
+        break;
+    }
+
+    for (int i = 0; i < PIECE_COUNT; i++) {
+        queue->pieces[(queue->head + queue->count) & QUEUE_MASK] = batch[i];
+        queue->count++;
+    }
+}
+
+/* Take the next piece off the queue, topping it up to a full preview */
+static PieceType take_piece(Game* game) {
+    PieceQueue* queue = &game->queue;
+    PieceType piece = (PieceType)queue->pieces[queue->head];
+
+    queue->head = (uint8_t)((queue->head + 1) & QUEUE_MASK);
+    queue->count--;
+    while (queue->count < GAME_PREVIEW_COUNT) {
+        refill_queue(game);
+    }
+    return piece;
+}
+
+/* Gravity interval in frames per row for a level */
+static int gravity_frames_for_level(int level) {
+    /* NES Tetris gravity speeds (frames per row @ 60fps) */
+    static const uint8_t GRAVITY_FRAMES[10] = {
+        48,  /* Level 1 */
+        43,  /* Level 2 */
+        38,  /* Level 3 */
+        33,  /* Level 4 */
+        28,  /* Level 5 */
+        23,  /* Level 6 */
+        18,  /* Level 7 */
+        13,  /* Level 8 */
+        8,   /* Level 9 */
+        6    /* Level 10 */
+    };
+
+    /* Clamp level to valid array bounds (1-10 -> index 0-9) */
+    int index = level - 1;
+    if (index < 0) {
+        index = 0;
+    } else if (index > 9) {
+        index = 9;
+    }
+
+    return GRAVITY_FRAMES[index];
+}
+
+/* Set the level and its cached gravity interval */
+static void set_level(Game* game, int level) {
+    game->level = level;
+    game->gravity_threshold = (uint8_t)gravity_frames_for_level(level);
+}
+
+/* Recompute cached landing row after the piece moved sideways, rotated
+ * or spawned (falling straight down never changes it) */
+static void update_ghost(Game* game) {
+    game->ghost_y = board_drop_y(&game->board, game->current_piece,
+                                 game->current_rotation,
+                                 game->piece_x, game->piece_y);
+}
+
 /* Initialize new game (starts at start screen) */
 void game_init(Game* game) {
+    game_init_seeded(game, GAME_DEFAULT_SEED);
+}
+
+/* Initialize new game with explicit randomizer seed */
+void game_init_seeded(Game* game, uint64_t seed) {
+    game_init_randomized(game, seed, RANDOMIZER_UNIFORM);
+}
+
+/* Initialize new game with explicit seed and randomizer */
+void game_init_randomized(Game* game, uint64_t seed, Randomizer randomizer) {
     /* Initialize board */
     board_init(&game->board);
 
@@ -38,24 +165,39 @@ void game_init(Game* game) {
 
     /* Initialize stats */
     game->score = 0;
-    game->level = 1;
+    set_level(game, 1);
     game->lines_cleared = 0;
     game->session_high_score = 0;
+    game->last_cleared_rows = 0;
+    game->pieces_locked = 0;
 
     /* Initialize timers */
-    game->gravity_timer = 0.0;
-    game->lock_delay_timer = 0.0;
+    game->gravity_frames = 0;
+    game->lock_delay_frames = 0;
     game->is_on_ground = false;
-
-    /* Seed random number generator */
-    srand((unsigned int)time(NULL));
-
-    /* Generate first two pieces (but don't spawn yet) */
-    game->current_piece = (PieceType)(rand() % PIECE_COUNT);
-    game->next_piece = (PieceType)(rand() % PIECE_COUNT);
+    game->frame_count = 0;
+    game->shift_direction = 0;
+    game->shift_held = false;
+    game->shift_frames = 0;
+    game->shift_idle_frames = 0;
+
+    /* No lock observer until one is installed */
+    game->lock_hook = NULL;
+    game->lock_hook_ctx = NULL;
+    game->lock_hook_board = false;
+
+    /* Seed per-game random number generator */
+    rng_seed(&game->rng, seed);
+
+    /* Fill the queue and take the first piece (but don't spawn yet) */
+    memset(&game->queue, 0, sizeof(game->queue));
+    game->queue.randomizer = (uint8_t)randomizer;
+    refill_queue(game);
+    game->current_piece = take_piece(game);
     game->current_rotation = ROT_0;
-    game->piece_x = SPAWN_X;
-    game->piece_y = SPAWN_Y;
+    game->piece_x = BOARD_SPAWN_X;
+    game->piece_y = BOARD_SPAWN_Y;
+    update_ghost(game);
 }
 
 /* Set starting level and begin game from start screen */
@@ -68,7 +210,7 @@ void game_set_starting_level(Game* game, int level) {
     }
 
     /* Set the starting level */
-    game->level = level;
+    set_level(game, level);
 
     /* Transition from start screen to playing state */
     game->state = GAME_STATE_PLAYING;
@@ -82,18 +224,16 @@ void game_set_starting_level(Game* game, int level) {
 
 /* Spawn next piece */
 bool game_spawn_piece(Game* game) {
-    /* Move next piece to current */
-    game->current_piece = game->next_piece;
+    /* Move next piece to current (the queue refills itself) */
+    game->current_piece = take_piece(game);
     game->current_rotation = ROT_0;
-    game->piece_x = SPAWN_X;
-    game->piece_y = SPAWN_Y;
-
-    /* Generate new next piece */
-    game->next_piece = (PieceType)(rand() % PIECE_COUNT);
+    game->piece_x = BOARD_SPAWN_X;
+    game->piece_y = BOARD_SPAWN_Y;
 
     /* Reset ground state */
     game->is_on_ground = false;
-    game->lock_delay_timer = 0.0;
+    game->lock_delay_frames = 0;
+    update_ghost(game);
 
     /* Check if spawn position is valid */
     if (board_check_collision(&game->board, game->current_piece,
@@ -114,53 +254,106 @@ static void update_high_score(Game* game) {
 
 /* Lock current piece and handle line clearing */
 static void lock_and_clear(Game* game) {
+    /* Keep the pre-lock board for the lock hook (only if it wants it) */
+    Board before;
+    int score_before = game->score;
+    if (game->lock_hook_board) {
+        before = game->board;
+    }
+
     /* Lock piece into board */
     board_lock_piece(&game->board, game->current_piece,
                      game->current_rotation, game->piece_x, game->piece_y);
 
     /* Clear lines and update score */
-    int lines = board_clear_lines(&game->board);
+    game->pieces_locked++;
+    game->last_cleared_rows = board_clear_lines_mask(&game->board);
+    int lines = BOARD_ROWSET_COUNT(game->last_cleared_rows);
     if (lines > 0) {
         game->lines_cleared += lines;
         game->score += LINE_CLEAR_SCORES[lines] * game->level;
         update_high_score(game);
 
         /* Check for level up */
-        game->level = 1 + (game->lines_cleared / LINES_PER_LEVEL);
+        int level = 1 + (game->lines_cleared / LINES_PER_LEVEL);
+        if (level != game->level) {
+            set_level(game, level);
+        }
+    }
+
+    if (game->lock_hook != NULL) {
+        GameLockEvent event = {
+            game->lock_hook_board ? &before : NULL,
+            game->current_piece, game->current_rotation,
+            game->piece_x, game->piece_y, game_get_next_piece(game),
+            lines, game->score - score_before
+        };
+        game->lock_hook(game, &event, game->lock_hook_ctx);
     }
 
     /* Spawn next piece */
     game_spawn_piece(game);
 }
 
-/* Check if piece is on ground */
+/* Check if piece is on ground: the cached landing row is the lowest
+ * free row below the piece, kept current whenever the piece moves
+ * sideways, rotates, spawns or the board changes under it */
 static bool is_grounded(const Game* game) {
-    return board_check_collision(&game->board, game->current_piece,
-                                 game->current_rotation,
-                                 game->piece_x, game->piece_y + 1);
+    return game->piece_y >= game->ghost_y;
+}
+
+/* Update game state by a number of frames */
+void game_update(Game* game, int frames) {
+    game_step_frames(game, frames);
+}
+
+/* Advance held-key auto-shift by one frame */
+static void step_shift(Game* game) {
+    game->shift_idle_frames++;
+
+    /* No event for too long: the key was released */
+    int idle_limit = game->shift_held ? SHIFT_REPEAT_FRAMES : SHIFT_PRESS_FRAMES;
+    if (game->shift_idle_frames > idle_limit) {
+        game->shift_direction = 0;
+        game->shift_held = false;
+        return;
+    }
+
+    if (game->shift_frames < SHIFT_DAS_FRAMES) {
+        game->shift_frames++;
+    }
+    if (game->shift_held && game->shift_frames >= SHIFT_DAS_FRAMES) {
+        game->shift_frames = SHIFT_DAS_FRAMES - SHIFT_ARR_FRAMES;
+        if (game->shift_direction < 0) {
+            game_move_left(game);
+        } else {
+            game_move_right(game);
+        }
+    }
 }
 
-/* Update game state */
-void game_update(Game* game, double delta_time) {
+/* Advance game by exactly one frame */
+void game_step_frame(Game* game) {
     if (game->state != GAME_STATE_PLAYING) {
         return;
     }
 
-    /* Update gravity timer */
-    game->gravity_timer += delta_time;
-    double gravity_speed = game_get_gravity_speed(game);
+    game->frame_count++;
+
+    if (game->shift_direction != 0) {
+        step_shift(game);
+    }
 
     /* Apply gravity */
-    if (game->gravity_timer >= gravity_speed) {
-        game->gravity_timer = 0.0;
+    game->gravity_frames++;
+    if (game->gravity_frames >= game->gravity_threshold) {
+        game->gravity_frames = 0;
 
         /* Try to move piece down */
-        if (!board_check_collision(&game->board, game->current_piece,
-                                   game->current_rotation,
-                                   game->piece_x, game->piece_y + 1)) {
+        if (!is_grounded(game)) {
             game->piece_y++;
             game->is_on_ground = false;
-            game->lock_delay_timer = 0.0;
+            game->lock_delay_frames = 0;
         } else {
             game->is_on_ground = true;
         }
@@ -169,16 +362,82 @@ void game_update(Game* game, double delta_time) {
     /* Handle lock delay */
     if (game->is_on_ground || is_grounded(game)) {
         game->is_on_ground = true;
-        game->lock_delay_timer += delta_time;
+        game->lock_delay_frames++;
 
-        if (game->lock_delay_timer >= LOCK_DELAY) {
+        if (game->lock_delay_frames >= LOCK_DELAY_FRAMES) {
             lock_and_clear(game);
         }
     } else {
-        game->lock_delay_timer = 0.0;
+        game->lock_delay_frames = 0;
     }
 }
 
+/* Advance many frames, jumping over frames where only counters move */
+void game_step_frames(Game* game, int n) {
+    while (n > 0 && game->state == GAME_STATE_PLAYING) {
+        /* Held keys tick every frame and time out within a few dozen */
+        if (game->shift_direction != 0) {
+            game_step_frame(game);
+            n--;
+            continue;
+        }
+
+        /* Frames before the next gravity step or lock: the piece does not
+         * move, so only the frame, gravity and lock counters advance */
+        bool grounded = game->is_on_ground || is_grounded(game);
+        int quiet = game->gravity_threshold - game->gravity_frames - 1;
+        if (grounded && LOCK_DELAY_FRAMES - game->lock_delay_frames - 1 < quiet) {
+            quiet = LOCK_DELAY_FRAMES - game->lock_delay_frames - 1;
+        }
+        if (quiet > n) {
+            quiet = n;
+        }
+        if (quiet > 0) {
+            game->frame_count += (uint32_t)quiet;
+            game->gravity_frames = (uint8_t)(game->gravity_frames + quiet);
+            if (grounded) {
+                game->is_on_ground = true;
+                game->lock_delay_frames = (uint8_t)(game->lock_delay_frames + quiet);
+            } else {
+                game->lock_delay_frames = 0;
+            }
+            n -= quiet;
+        }
+
+        /* The event frame itself */
+        if (n > 0) {
+            game_step_frame(game);
+            n--;
+        }
+    }
+}
+
+/* Frames until next gravity step or lock */
+int game_frames_until_event(const Game* game) {
+    if (game->state != GAME_STATE_PLAYING) {
+        return -1;
+    }
+
+    int frames = game->gravity_threshold - game->gravity_frames;
+
+    if (game->is_on_ground || is_grounded(game)) {
+        int lock_frames = LOCK_DELAY_FRAMES - game->lock_delay_frames;
+        if (lock_frames < frames) {
+            frames = lock_frames;
+        }
+    }
+
+    /* Next auto-shift move of a held key */
+    if (game->shift_direction != 0 && game->shift_held) {
+        int shift = SHIFT_DAS_FRAMES - game->shift_frames;
+        if (shift < frames) {
+            frames = shift;
+        }
+    }
+
+    return frames > 1 ? frames : 1;
+}
+
 /* Move piece left */
 bool game_move_left(Game* game) {
     if (game->state != GAME_STATE_PLAYING) {
@@ -189,11 +448,12 @@ bool game_move_left(Game* game) {
     if (!board_check_collision(&game->board, game->current_piece,
                                game->current_rotation, new_x, game->piece_y)) {
         game->piece_x = new_x;
+        update_ghost(game);
 
         /* Reset lock delay if moving off ground */
         if (!is_grounded(game)) {
             game->is_on_ground = false;
-            game->lock_delay_timer = 0.0;
+            game->lock_delay_frames = 0;
         }
 
         return true;
@@ -212,11 +472,12 @@ bool game_move_right(Game* game) {
     if (!board_check_collision(&game->board, game->current_piece,
                                game->current_rotation, new_x, game->piece_y)) {
         game->piece_x = new_x;
+        update_ghost(game);
 
         /* Reset lock delay if moving off ground */
         if (!is_grounded(game)) {
             game->is_on_ground = false;
-            game->lock_delay_timer = 0.0;
+            game->lock_delay_frames = 0;
         }
 
         return true;
@@ -238,13 +499,41 @@ bool game_move_down(Game* game) {
         game->score += 1;  /* Award 1 point for soft drop */
         update_high_score(game);
         game->is_on_ground = false;
-        game->lock_delay_timer = 0.0;
+        game->lock_delay_frames = 0;
         return true;
     }
 
     return false;
 }
 
+/* Horizontal key event with inferred hold */
+bool game_shift_press(Game* game, int direction) {
+    if (game->state != GAME_STATE_PLAYING || direction == 0) {
+        return false;
+    }
+    direction = direction < 0 ? -1 : 1;
+
+    if (direction == game->shift_direction) {
+        if (game->shift_idle_frames <= SHIFT_REPEAT_FRAMES) {
+            /* Terminal autorepeat: key is held, the game does the moving */
+            game->shift_held = true;
+            game->shift_idle_frames = 0;
+            return false;
+        }
+
+        /* Same key tapped again: move, keep the charge since the press */
+        game->shift_held = false;
+    } else {
+        /* New key: restart the charge */
+        game->shift_direction = (int8_t)direction;
+        game->shift_held = false;
+        game->shift_frames = 0;
+    }
+
+    game->shift_idle_frames = 0;
+    return direction < 0 ? game_move_left(game) : game_move_right(game);
+}
+
 /* Rotate piece clockwise with wall kicks */
 bool game_rotate(Game* game) {
     if (game->state != GAME_STATE_PLAYING) {
@@ -252,23 +541,26 @@ bool game_rotate(Game* game) {
     }
 
     RotationState new_rotation = piece_rotate_cw(game->current_rotation);
+    const PieceInfo* info = piece_get_info(game->current_piece, new_rotation);
+    const PieceKick* kicks = piece_get_kicks();
 
-    /* Try rotation with wall kick offsets */
-    for (int i = 0; i < WALL_KICK_COUNT; i++) {
-        int test_x = game->piece_x + WALL_KICK_OFFSETS[i][0];
-        int test_y = game->piece_y + WALL_KICK_OFFSETS[i][1];
+    /* Try rotation with wall kick offsets (out-of-bounds candidates are
+     * rejected from the bounding box before any board access) */
+    for (int i = 0; i < PIECE_KICK_COUNT; i++) {
+        int test_x = game->piece_x + kicks[i].dx;
+        int test_y = game->piece_y + kicks[i].dy;
 
-        if (!board_check_collision(&game->board, game->current_piece,
-                                   new_rotation, test_x, test_y)) {
+        if (!board_collides(&game->board, info, test_x, test_y)) {
             /* Rotation successful */
             game->current_rotation = new_rotation;
             game->piece_x = test_x;
             game->piece_y = test_y;
+            update_ghost(game);
 
             /* Reset lock delay if rotating off ground */
             if (!is_grounded(game)) {
                 game->is_on_ground = false;
-                game->lock_delay_timer = 0.0;
+                game->lock_delay_frames = 0;
             }
 
             return true;
@@ -284,14 +576,9 @@ void game_hard_drop(Game* game) {
         return;
     }
 
-    /* Move piece down until collision */
-    int drop_distance = 0;
-    while (!board_check_collision(&game->board, game->current_piece,
-                                  game->current_rotation,
-                                  game->piece_x, game->piece_y + 1)) {
-        game->piece_y++;
-        drop_distance++;
-    }
+    /* Move piece straight to its cached landing row */
+    int drop_distance = game->ghost_y - game->piece_y;
+    game->piece_y = game->ghost_y;
 
     /* Award points for hard drop (2 points per row) */
     game->score += drop_distance * 2;
@@ -301,6 +588,152 @@ void game_hard_drop(Game* game) {
     lock_and_clear(game);
 }
 
+/* Place piece at target rotation/x and hard drop */
+bool game_place(Game* game, RotationState rotation, int x) {
+    if (game->state != GAME_STATE_PLAYING) {
+        return false;
+    }
+
+    if (board_check_collision(&game->board, game->current_piece,
+                              rotation, x, game->piece_y)) {
+        return false;
+    }
+
+    game->current_rotation = rotation;
+    game->piece_x = x;
+    update_ghost(game);
+    game_hard_drop(game);
+    return true;
+}
+
+/* Apply one programmatic action */
+bool game_apply_action(Game* game, const Action* action) {
+    switch (action->type) {
+        case ACTION_LEFT:
+            return game_move_left(game);
+        case ACTION_RIGHT:
+            return game_move_right(game);
+        case ACTION_SOFT_DROP:
+            return game_move_down(game);
+        case ACTION_ROTATE:
+            return game_rotate(game);
+        case ACTION_HARD_DROP:
+            if (game->state != GAME_STATE_PLAYING) {
+                return false;
+            }
+            game_hard_drop(game);
+            return true;
+        case ACTION_PLACE:
+            return game_place(game, action->rotation, action->x);
+        case ACTION_NONE:
+            break;
+    }
+
+    return false;
+}
+
+/* Push opponent garbage under the stack */
+bool game_receive_garbage(Game* game, int rows, int hole_x) {
+    if (game->state != GAME_STATE_PLAYING) {
+        return false;
+    }
+
+    bool fits = board_push_garbage(&game->board, rows, hole_x);
+    if (!fits || board_check_collision(&game->board, game->current_piece,
+                                       game->current_rotation,
+                                       game->piece_x, game->piece_y)) {
+        game->state = GAME_STATE_GAME_OVER;
+        return false;
+    }
+
+    /* The stack moved, so landing row and ground contact may have too */
+    update_ghost(game);
+    game->is_on_ground = is_grounded(game);
+    if (!game->is_on_ground) {
+        game->lock_delay_frames = 0;
+    }
+    return true;
+}
+
+/* Pack game state into a snapshot */
+void game_snapshot(const Game* game, GameSnapshot* snapshot) {
+    snapshot->score = (uint32_t)game->score;
+    snapshot->lines_cleared = (uint32_t)game->lines_cleared;
+    snapshot->frame_count = game->frame_count;
+    snapshot->level = (uint16_t)game->level;
+    snapshot->pieces = (uint8_t)(game->current_piece |
+                                 game->current_rotation << 3 |
+                                 game->queue.randomizer << 5);
+
+    /* Queue as the batches it came from: more than a batch queued means
+     * the previous one is still in it */
+    int oldest = game->queue.count > PIECE_COUNT ? 0 : 1;
+    snapshot->rng_state = game->queue.batch_rng[oldest];
+    snapshot->queue = (uint8_t)(game->queue.count | game->queue.batch_last[oldest] << 4);
+    snapshot->piece_x = (int8_t)game->piece_x;
+    snapshot->piece_y = (int8_t)game->piece_y;
+    snapshot->gravity_frames = game->gravity_frames;
+    snapshot->lock_delay_frames = game->lock_delay_frames;
+    snapshot->shift_frames = game->shift_frames;
+    snapshot->shift_idle_frames = game->shift_idle_frames;
+    snapshot->flags = (uint8_t)(game->state | (game->is_on_ground ? 1u << 2 : 0u) |
+                                (game->shift_held ? 1u << 3 : 0u) |
+                                (unsigned)(game->shift_direction + 1) << 4);
+
+    board_pack(&game->board, snapshot->cells);
+}
+
+/* Restore game state from a snapshot */
+void game_restore(Game* game, const GameSnapshot* snapshot) {
+    board_unpack(&game->board, snapshot->cells);
+
+    game->score = (int)snapshot->score;
+    game->lines_cleared = (int)snapshot->lines_cleared;
+    game->frame_count = snapshot->frame_count;
+    set_level(game, snapshot->level);
+    game->current_piece = (PieceType)(snapshot->pieces & 0x7);
+    game->current_rotation = (RotationState)((snapshot->pieces >> 3) & 0x3);
+    game->queue.randomizer = (uint8_t)(snapshot->pieces >> 5);
+
+    /* Redraw the queue's batches behind the piece before them (the NES
+     * randomizer reads it), then drop what was already taken; this also
+     * leaves the Rng where the original's is */
+    int count = snapshot->queue & 0xF;
+    int last = snapshot->queue >> 4;
+    game->rng.state = snapshot->rng_state;
+    game->queue.head = 0;
+    game->queue.count = 0;
+    if (last < PIECE_COUNT) {
+        game->queue.pieces[game->queue.count++] = (uint8_t)last;
+    }
+    for (int batch = count > PIECE_COUNT ? 2 : 1; batch > 0; batch--) {
+        refill_queue(game);
+    }
+    game->queue.head = (uint8_t)(game->queue.count - count);
+    game->queue.count = (uint8_t)count;
+    game->piece_x = snapshot->piece_x;
+    game->piece_y = snapshot->piece_y;
+    game->gravity_frames = snapshot->gravity_frames;
+    game->lock_delay_frames = snapshot->lock_delay_frames;
+    game->state = (GameState)(snapshot->flags & 0x3);
+    game->is_on_ground = (snapshot->flags & (1u << 2)) != 0;
+    game->last_cleared_rows = 0;
+    game->shift_frames = snapshot->shift_frames;
+    game->shift_idle_frames = snapshot->shift_idle_frames;
+    game->shift_held = (snapshot->flags & (1u << 3)) != 0;
+    game->shift_direction = (int8_t)(((snapshot->flags >> 4) & 0x3) - 1);
+
+    update_ghost(game);
+    update_high_score(game);
+}
+
+/* Install lock observer */
+void game_set_lock_hook(Game* game, GameLockHook hook, void* ctx, bool with_board) {
+    game->lock_hook = hook;
+    game->lock_hook_ctx = ctx;
+    game->lock_hook_board = hook != NULL && with_board;
+}
+
 /* Toggle pause state */
 void game_toggle_pause(Game* game) {
     if (game->state == GAME_STATE_PLAYING) {
@@ -342,49 +775,46 @@ int game_get_session_high_score(const Game* game) {
 
 /* Get next piece for preview */
 PieceType game_get_next_piece(const Game* game) {
-    return game->next_piece;
+    return (PieceType)game->queue.pieces[game->queue.head];
 }
 
-/* Calculate gravity speed based on level */
-double game_get_gravity_speed(const Game* game) {
-    /* NES Tetris gravity speeds (frames @ 60fps converted to seconds/row) */
-    static const double GRAVITY_SPEEDS[10] = {
-        0.800,  /* Level 1:  48 frames */
-        0.717,  /* Level 2:  43 frames */
-        0.633,  /* Level 3:  38 frames */
-        0.550,  /* Level 4:  33 frames */
-        0.467,  /* Level 5:  28 frames */
-        0.383,  /* Level 6:  23 frames */
-        0.300,  /* Level 7:  18 frames */
-        0.217,  /* Level 8:  13 frames */
-        0.133,  /* Level 9:   8 frames */
-        0.100   /* Level 10:  6 frames */
-    };
-
-    /* Clamp level to valid array bounds (1-10 -> index 0-9) */
-    int index = game->level - 1;
-    if (index < 0) {
-        index = 0;
-    } else if (index > 9) {
-        index = 9;
+PieceType game_peek_piece(const Game* game, int index) {
+    if (index < 0 || index >= GAME_PREVIEW_COUNT) {
+        return PIECE_COUNT;
     }
+    return (PieceType)game->queue.pieces[(game->queue.head + index) & QUEUE_MASK];
+}
 
-    return GRAVITY_SPEEDS[index];
+/* Get gravity interval in frames per row based on level */
+int game_get_gravity_frames(const Game* game) {
+    return game->gravity_threshold;
+}
+
+/* Calculate gravity speed in seconds based on level */
+double game_get_gravity_speed(const Game* game) {
+    return (double)game_get_gravity_frames(game) / GAME_FRAME_RATE;
 }
 
-/* Get ghost piece Y position (hard drop simulation) */
+/* Get ghost piece Y position (where a hard drop would land) */
 int game_get_ghost_y(const Game* game) {
     if (game->state != GAME_STATE_PLAYING) {
         return game->piece_y;
     }
 
-    /* Simulate hard drop - find lowest valid Y position */
-    int ghost_y = game->piece_y;
-    while (!board_check_collision(&game->board, game->current_piece,
-                                  game->current_rotation,
-                                  game->piece_x, ghost_y + 1)) {
-        ghost_y++;
+    /* Cached landing row, kept current by every sideways move/rotation */
+    return game->ghost_y;
+}
+
+/* Get ghost piece Y position by dropping one row at a time */
+int game_get_ghost_y_scalar(const Game* game) {
+    int y = game->piece_y;
+    if (game->state != GAME_STATE_PLAYING) {
+        return y;
     }
 
-    return ghost_y;
+    while (!board_check_collision_scalar(&game->board, game->current_piece,
+                                         game->current_rotation, game->piece_x, y + 1)) {
+        y++;
+    }
+    return y;
 }
@@ -2,8 +2,13 @@
 #define GAME_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "board.h"
 #include "piece.h"
+#include "rng.h"
+
+/* Simulation rate: game logic always advances in whole frames of 1/60 s */
+#define GAME_FRAME_RATE 60
 
 /* Game state enumeration */
 typedef enum {
@@ -13,8 +18,74 @@ typedef enum {
     GAME_STATE_GAME_OVER
 } GameState;
 
-/* Game state structure */
+/* Programmatic player action (bots, batch rollouts) */
+typedef enum {
+    ACTION_NONE,
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_SOFT_DROP,
+    ACTION_ROTATE,
+    ACTION_HARD_DROP,
+    ACTION_PLACE      /* Move to (rotation, x) at current height, then hard drop */
+} ActionType;
+
+typedef struct {
+    ActionType type;
+    RotationState rotation;  /* ACTION_PLACE only: target rotation */
+    int x;                   /* ACTION_PLACE only: target piece_x */
+} Action;
+
+/* Piece sequence generators (see game_init_randomized) */
+typedef enum {
+    RANDOMIZER_UNIFORM,  /* Independent uniform draws (default) */
+    RANDOMIZER_NES,      /* NES-style: a repeat of the last piece is rerolled once */
+    RANDOMIZER_BAG,      /* 7-bag: every batch is a shuffle of all 7 pieces */
+    RANDOMIZER_COUNT
+} Randomizer;
+
+/* Upcoming pieces that can always be peeked (see game_peek_piece) */
+#define GAME_PREVIEW_COUNT 5
+
+/* Ring capacity of the piece queue (power of two, room for
+ * GAME_PREVIEW_COUNT - 1 pieces plus one batch of PIECE_COUNT) */
+#define GAME_QUEUE_SIZE 16
+
+/* Upcoming pieces after the current one, in spawn order. Refilled one
+ * batch of PIECE_COUNT pieces at a time whenever fewer than
+ * GAME_PREVIEW_COUNT remain, so the queued pieces always come from the
+ * last two batches; a plain value, so forking a game copies it */
 typedef struct {
+    uint8_t pieces[GAME_QUEUE_SIZE];  /* Ring of PieceType */
+    uint8_t head;                     /* Ring index of the next piece */
+    uint8_t count;                    /* Pieces queued */
+    uint8_t randomizer;               /* Randomizer refilling the queue */
+    uint8_t batch_last[2];            /* Piece queued before the previous and
+                                       * the latest batch (PIECE_COUNT = none) */
+    uint64_t batch_rng[2];            /* Rng state each was drawn from, so a
+                                       * snapshot can redraw the queue */
+} PieceQueue;
+
+struct Game;
+
+/* Details of one piece lock, passed to a GameLockHook */
+typedef struct {
+    const Board* board;      /* Board just before the piece was locked
+                              * (NULL unless game_set_lock_hook asked) */
+    PieceType piece;         /* Locked piece and its final position */
+    RotationState rotation;
+    int x;
+    int y;
+    PieceType next_piece;    /* Preview piece at lock time */
+    int lines;               /* Lines cleared by this lock (0-4) */
+    int score_delta;         /* Points awarded for the clear */
+} GameLockEvent;
+
+/* Observer called from inside the game for every locked piece */
+typedef void (*GameLockHook)(const struct Game* game, const GameLockEvent* event,
+                             void* ctx);
+
+/* Game state structure */
+typedef struct Game {
     Board board;
     GameState state;
 
@@ -23,45 +94,158 @@ typedef struct {
     RotationState current_rotation;
     int piece_x;
     int piece_y;
+    int ghost_y;  /* Cached landing row of current piece */
 
-    /* Next piece for preview */
-    PieceType next_piece;
+    /* Upcoming pieces for preview (head is the next piece) */
+    PieceQueue queue;
 
     /* Game statistics */
     int score;
     int level;
     int lines_cleared;
     int session_high_score;  /* Highest score this session (not persisted) */
+    board_rowset_t last_cleared_rows;  /* Rows cleared by the last lock (bit y =
+                                        * row y before the clear), for clear
+                                        * animations */
+    uint32_t pieces_locked;  /* Locks so far: a change means a new lock and
+                              * last_cleared_rows (no hook needed) */
 
-    /* Timing state */
-    double gravity_timer;
-    double lock_delay_timer;
+    /* Timing state (integer frame counters, see GAME_FRAME_RATE) */
+    uint8_t gravity_frames;     /* Frames since last gravity step */
+    uint8_t gravity_threshold;  /* Frames per gravity step at the current
+                                 * level (cached, see game_get_gravity_frames) */
+    uint8_t lock_delay_frames;  /* Frames spent grounded */
     bool is_on_ground;  /* Track if piece is currently grounded */
+    uint32_t frame_count;  /* Frames simulated while playing */
+
+    /* Held-key horizontal auto-shift (see game_shift_press) */
+    int8_t shift_direction;     /* -1 left, 1 right, 0 no key held */
+    bool shift_held;            /* Key repeat seen: auto-shift active */
+    uint8_t shift_frames;       /* Delayed auto-shift charge (frames) */
+    uint8_t shift_idle_frames;  /* Frames since the last key event */
+
+    /* Per-game piece randomizer (no shared global state) */
+    Rng rng;
+
+    /* Optional lock observer (see game_set_lock_hook) */
+    GameLockHook lock_hook;
+    void* lock_hook_ctx;
+    bool lock_hook_board;  /* Hook receives the pre-lock board */
 } Game;
 
-/* Initialize new game (starts at start screen) */
+/* Packed copy of everything that determines how a game continues
+ * (see game_snapshot). 56 bytes on the default board, well within one
+ * 64-byte cache line (larger variants need a bigger occupancy array).
+ * The piece queue is not stored: restoring redraws its batches from the
+ * Rng state they were drawn from. Cell colors, the session high score
+ * and the lock count are not kept. */
+typedef struct {
+    uint64_t rng_state;         /* Rng before the queue's oldest batch */
+    uint32_t score;
+    uint32_t lines_cleared;
+    uint32_t frame_count;
+    uint16_t level;
+    uint8_t cells[BOARD_PACKED_BYTES];  /* Occupancy (board_pack) */
+    uint8_t pieces;             /* current | rotation << 3 | randomizer << 5 */
+    uint8_t queue;              /* count | piece before that batch << 4 */
+    int8_t piece_x;
+    int8_t piece_y;
+    uint8_t gravity_frames;
+    uint8_t lock_delay_frames;
+    uint8_t shift_frames;
+    uint8_t shift_idle_frames;
+    uint8_t flags;              /* state | is_on_ground << 2 |
+                                 * shift_held << 3 | (shift_direction + 1) << 4 */
+} GameSnapshot;
+
+/* Initialize new game (starts at start screen) with a fixed default seed */
 void game_init(Game* game);
 
+/* Initialize new game with explicit randomizer seed
+ * Equal seeds and inputs always reproduce the same game */
+void game_init_seeded(Game* game, uint64_t seed);
+
+/* Same, drawing pieces with the given randomizer (game_init_seeded uses
+ * RANDOMIZER_UNIFORM) */
+void game_init_randomized(Game* game, uint64_t seed, Randomizer randomizer);
+
 /* Set starting level (1-10) and begin game from start screen */
 void game_set_starting_level(Game* game, int level);
 
 /* Spawn next piece at top-center (returns false if game over) */
 bool game_spawn_piece(Game* game);
 
-/* Update game state with delta time (handles gravity and lock delay) */
-void game_update(Game* game, double delta_time);
+/* Update game state by whole frames (handles gravity and lock delay)
+ * Callers driven by wall-clock time convert elapsed seconds to frames */
+void game_update(Game* game, int frames);
+
+/* Advance n frames exactly like n calls to game_step_frame, but jump
+ * over runs of frames without a gravity step, lock or auto-shift move in
+ * O(1) each (stops early if the game leaves the playing state) */
+void game_step_frames(Game* game, int n);
+
+/* Advance game by exactly one frame (1 / GAME_FRAME_RATE seconds)
+ * Fixed-step entry point: a given sequence of frames and actions always
+ * produces the same game, independent of wall-clock timing */
+void game_step_frame(Game* game);
+
+/* Frames until the game next changes on its own (gravity step or lock)
+ * Returns -1 if nothing is scheduled (not playing) */
+int game_frames_until_event(const Game* game);
 
 /* Movement functions (return true if action succeeded) */
 bool game_move_left(Game* game);
 bool game_move_right(Game* game);
 bool game_move_down(Game* game);  /* Soft drop - awards 1 point */
 
+/* Horizontal key event from a terminal (direction -1 left, 1 right)
+ * Terminals report no key releases, only autorepeated presses, so holds
+ * are inferred: an event within a few frames of the previous one for the
+ * same direction is a repeat and marks the key held; anything else is a
+ * new press and moves the piece at once. While held, the game itself
+ * repeats the move (delayed auto-shift, then a fixed auto-repeat rate,
+ * counted in frames by game_step_frame) and the terminal's own repeats
+ * only keep the hold alive. Returns true if the piece moved */
+bool game_shift_press(Game* game, int direction);
+
 /* Rotation with wall kicks (returns true if succeeded) */
 bool game_rotate(Game* game);
 
 /* Hard drop - instantly places piece, awards 2 points/row */
 void game_hard_drop(Game* game);
 
+/* Place piece at given rotation and x (at current height) and hard drop
+ * Returns false without changing state if that position collides */
+bool game_place(Game* game, RotationState rotation, int x);
+
+/* Apply one programmatic action (returns true if it succeeded) */
+bool game_apply_action(Game* game, const Action* action);
+
+/* Receive garbage from an opponent (versus play): push rows in from the
+ * bottom with the hole in column hole_x (board_push_garbage, which
+ * clamps it). Meant to be called right after a lock; if the pushed-up
+ * stack now overlaps the falling piece or went out through the top, the
+ * game is over
+ * Returns false if the game ended (or was not being played) */
+bool game_receive_garbage(Game* game, int rows, int hole_x);
+
+/* Pack game state into a snapshot */
+void game_snapshot(const Game* game, GameSnapshot* snapshot);
+
+/* Restore game state from a snapshot into an initialized game; play
+ * continues exactly as it would have from the original (redrawing the
+ * queue costs one or two batches of Rng draws). Board cells come
+ * back as BOARD_GARBAGE_COLOR; the session high score is kept (raised to
+ * the restored score if lower), as are the lock count and lock hook */
+void game_restore(Game* game, const GameSnapshot* snapshot);
+
+/* Install a lock observer, called after each lock's line clear and
+ * before the next piece spawns (NULL to remove). Runs on the thread that
+ * steps the game; game_init clears it. With with_board, event->board is
+ * the board before the lock, which costs a Board copy per lock; hooks
+ * that only count locks pass false and get NULL */
+void game_set_lock_hook(Game* game, GameLockHook hook, void* ctx, bool with_board);
+
 /* State management */
 void game_toggle_pause(Game* game);
 bool game_is_over(const Game* game);
@@ -74,10 +258,22 @@ int game_get_lines(const Game* game);
 int game_get_session_high_score(const Game* game);
 PieceType game_get_next_piece(const Game* game);
 
+/* Get an upcoming piece: 0 is the next piece, up to GAME_PREVIEW_COUNT - 1
+ * Returns PIECE_COUNT for indexes outside the preview */
+PieceType game_peek_piece(const Game* game, int index);
+
+/* Get gravity interval in frames per row (level-dependent) */
+int game_get_gravity_frames(const Game* game);
+
 /* Get gravity speed in seconds per row (level-dependent) */
 double game_get_gravity_speed(const Game* game);
 
 /* Get ghost piece Y position (where current piece will land) */
 int game_get_ghost_y(const Game* game);
 
+/* Reference implementation of game_get_ghost_y: steps the piece down a
+ * row at a time with board_check_collision_scalar instead of reading the
+ * cached landing row (for the benchmark suite's differential checks) */
+int game_get_ghost_y_scalar(const Game* game);
+
 #endif /* GAME_H */
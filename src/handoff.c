@@ -0,0 +1,50 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "handoff.h"
+#include <errno.h>
+
+/* Set in middle when its slot holds a frame the reader has not taken */
+#define HANDOFF_FRESH 0x4u
+#define HANDOFF_INDEX 0x3u
+
+bool handoff_init(FrameHandoff* handoff) {
+    handoff->back = 0;
+    handoff->middle = 1;
+    handoff->front = 2;
+    return sem_init(&handoff->published, 0, 0) == 0;
+}
+
+HandoffFrame* handoff_back(FrameHandoff* handoff) {
+    return &handoff->slots[handoff->back];
+}
+
+void handoff_publish(FrameHandoff* handoff) {
+    /* Release: the slot's contents are visible before its index is */
+    uint32_t previous = __atomic_exchange_n(&handoff->middle,
+                                            (uint32_t)handoff->back | HANDOFF_FRESH,
+                                            __ATOMIC_ACQ_REL);
+    handoff->back = (int)(previous & HANDOFF_INDEX);
+    sem_post(&handoff->published);
+}
+
+const HandoffFrame* handoff_wait(FrameHandoff* handoff) {
+    for (;;) {
+        while (sem_wait(&handoff->published) != 0 && errno == EINTR) {
+        }
+        /* Collapse posts for frames that are about to be skipped anyway */
+        while (sem_trywait(&handoff->published) == 0) {
+        }
+
+        if (__atomic_load_n(&handoff->middle, __ATOMIC_ACQUIRE) & HANDOFF_FRESH) {
+            uint32_t previous = __atomic_exchange_n(&handoff->middle,
+                                                    (uint32_t)handoff->front,
+                                                    __ATOMIC_ACQ_REL);
+            handoff->front = (int)(previous & HANDOFF_INDEX);
+            return &handoff->slots[handoff->front];
+        }
+    }
+}
+
+void handoff_cleanup(FrameHandoff* handoff) {
+    sem_destroy(&handoff->published);
+}
@@ -0,0 +1,80 @@
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "framestats.h"
+#include "game.h"
+
+/**
+ * handoff.h - Lock-free frame handoff between simulation and render threads
+ *
+ * A triple buffer: the simulation thread fills its private back slot and
+ * publishes it with one atomic exchange, and the render thread takes the
+ * most recently published slot with another. Neither side ever waits for
+ * the other - a render thread stuck in a slow terminal write just skips
+ * to the newest state once it returns, and the simulation keeps its
+ * fixed 60 Hz input and gravity cadence meanwhile.
+ *
+ * A semaphore lets the render thread sleep until something new is
+ * published; posting it never blocks the publisher.
+ */
+
+/* Everything the render thread draws from (an immutable copy) */
+typedef struct {
+    Game game;
+    int selected_level;
+    bool quit;         /* Last frame: render it, then stop */
+    FrameStats stats;  /* Simulation-side phases (--debug-stats) */
+} HandoffFrame;
+
+typedef struct {
+    HandoffFrame slots[3];
+    uint32_t middle;  /* Published slot index | HANDOFF_FRESH (atomic) */
+    int back;         /* Slot owned by the writer */
+    int front;        /* Slot owned by the reader */
+    sem_t published;  /* Posted once per publish */
+} FrameHandoff;
+
+/**
+ * Initialize handoff (no frame published yet).
+ *
+ * @param handoff Pointer to handoff structure
+ * @return false if the semaphore could not be created
+ */
+bool handoff_init(FrameHandoff* handoff);
+
+/**
+ * Get the writer's slot to fill (simulation thread only).
+ *
+ * @param handoff Pointer to initialized handoff
+ * @return Slot owned by the writer until handoff_publish
+ */
+HandoffFrame* handoff_back(FrameHandoff* handoff);
+
+/**
+ * Publish the writer's slot, replacing any frame the reader has not
+ * taken yet, and wake the reader (simulation thread only).
+ *
+ * @param handoff Pointer to initialized handoff
+ */
+void handoff_publish(FrameHandoff* handoff);
+
+/**
+ * Sleep until a frame is published, then take the newest one (render
+ * thread only). Frames published in the meantime are skipped.
+ *
+ * @param handoff Pointer to initialized handoff
+ * @return Newest frame, owned by the reader until the next call
+ */
+const HandoffFrame* handoff_wait(FrameHandoff* handoff);
+
+/**
+ * Release handoff resources.
+ *
+ * @param handoff Pointer to initialized handoff
+ */
+void handoff_cleanup(FrameHandoff* handoff);
+
+#endif /* HANDOFF_H */
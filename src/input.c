@@ -1,5 +1,14 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "input.h"
 #include <ncurses.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Raw descriptor mode (input_init_raw): -1 while reading through curses */
+static int raw_fd = -1;
+static struct termios saved_termios;
+static InputDecoder raw_decoder;
 
 void input_init(void) {
     /* Enable non-blocking mode for getch() */
@@ -15,15 +24,29 @@ void input_init(void) {
     curs_set(0);
 }
 
-InputAction input_poll(void) {
-    int ch = getch();
+bool input_init_raw(int fd) {
+    struct termios raw;
+    if (tcgetattr(fd, &saved_termios) != 0) {
+        return false;
+    }
 
-    /* No key pressed */
-    if (ch == ERR) {
-        return INPUT_NONE;
+    /* Like cbreak + noecho + nodelay: keys arrive one at a time, unechoed,
+     * and reads never block; Ctrl-C still interrupts */
+    raw = saved_termios;
+    raw.c_lflag &= (tcflag_t)~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &raw) != 0) {
+        return false;
     }
 
-    /* Map keys to actions */
+    raw_fd = fd;
+    input_decoder_init(&raw_decoder);
+    return true;
+}
+
+/* Map a curses key code to an action */
+static InputAction map_key(int ch) {
     switch (ch) {
         case KEY_LEFT:
             return INPUT_LEFT;
@@ -62,7 +85,131 @@ InputAction input_poll(void) {
     }
 }
 
+InputAction input_poll(void) {
+    if (raw_fd >= 0) {
+        InputAction action = INPUT_NONE;
+        input_poll_all(&action, 1);
+        return action;
+    }
+
+    int ch = getch();
+
+    /* No key pressed */
+    if (ch == ERR) {
+        return INPUT_NONE;
+    }
+
+    return map_key(ch);
+}
+
+int input_poll_all(InputAction* actions, int max_actions) {
+    int count = 0;
+
+    /* Raw mode: every key is at least one byte, so reading at most
+     * max_actions bytes never decodes more keys than fit */
+    if (raw_fd >= 0) {
+        unsigned char bytes[INPUT_BATCH_SIZE];
+        while (count < max_actions) {
+            size_t want = (size_t)(max_actions - count);
+            ssize_t n = read(raw_fd, bytes, want < sizeof(bytes) ? want : sizeof(bytes));
+            if (n <= 0) {
+                break;
+            }
+            count += input_decode(&raw_decoder, bytes, (size_t)n,
+                                  actions + count, max_actions - count);
+        }
+        return count;
+    }
+
+    /* Read until the queue is empty (getch is non-blocking) */
+    while (count < max_actions) {
+        int ch = getch();
+        if (ch == ERR) {
+            break;
+        }
+
+        InputAction action = map_key(ch);
+        if (action != INPUT_NONE) {
+            actions[count++] = action;
+        }
+    }
+
+    return count;
+}
+
+void input_decoder_init(InputDecoder* decoder) {
+    decoder->pending_len = 0;
+    decoder->after_cr = false;
+}
+
+/* Map the final byte of an arrow key sequence to its curses key code */
+static int arrow_key(unsigned char final) {
+    switch (final) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        default: return ERR;
+    }
+}
+
+int input_decode(InputDecoder* decoder, const unsigned char* bytes, size_t length,
+                 InputAction* actions, int max_actions) {
+    int count = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        unsigned char byte = bytes[i];
+        int ch = ERR;
+
+        if (decoder->pending_len == 0) {
+            if (byte == 0x1B) {
+                decoder->pending[decoder->pending_len++] = byte;
+                continue;
+            }
+            if ((byte == '\n' || byte == '\0') && decoder->after_cr) {
+                decoder->after_cr = false;
+                continue;
+            }
+            decoder->after_cr = byte == '\r';
+            ch = byte;
+        } else if (decoder->pending_len == 1) {
+            /* ESC seen: CSI or SS3 introducer, anything else cancels it */
+            if (byte == '[' || byte == 'O') {
+                decoder->pending[decoder->pending_len++] = byte;
+                continue;
+            }
+            if (byte == 0x1B) {
+                continue;  /* Lone ESC, the new one may start a sequence */
+            }
+            decoder->pending_len = 0;
+            decoder->after_cr = false;
+            ch = byte;
+        } else {
+            /* Parameter bytes (e.g. ESC [ 1 ; 2 A) are skipped */
+            if (byte >= '0' && byte <= '?') {
+                continue;
+            }
+            decoder->pending_len = 0;
+            decoder->after_cr = false;
+            ch = arrow_key(byte);
+        }
+
+        InputAction action = ch != ERR ? map_key(ch) : INPUT_NONE;
+        if (action != INPUT_NONE && count < max_actions) {
+            actions[count++] = action;
+        }
+    }
+
+    return count;
+}
+
 void input_cleanup(void) {
+    if (raw_fd >= 0) {
+        tcsetattr(raw_fd, TCSANOW, &saved_termios);
+        raw_fd = -1;
+        return;
+    }
+
     /* Restore blocking mode */
     nodelay(stdscr, FALSE);
 
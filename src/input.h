@@ -1,10 +1,14 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 /**
  * Input Module - Non-blocking keyboard input handling
  *
- * Provides ncurses-based keyboard input with non-blocking polling.
+ * Provides ncurses-based keyboard input with non-blocking polling, or
+ * raw terminal reads with a built-in escape-sequence decoder.
  * Maps keyboard keys to game actions for Tetris controls.
  */
 
@@ -20,12 +24,32 @@ typedef enum {
     INPUT_START
 } InputAction;
 
+/* Capacity callers use for one input_poll_all batch */
+#define INPUT_BATCH_SIZE 64
+
+/* Byte-stream key decoder state (raw terminal or network input, where
+ * escape sequences can be split across reads) */
+typedef struct {
+    unsigned char pending[2];  /* Partial escape sequence (ESC, '[' or 'O') */
+    int pending_len;
+    bool after_cr;  /* Last byte was CR: swallow a following LF or NUL */
+} InputDecoder;
+
 /**
  * Initialize input system
  * Configures ncurses for non-blocking input with keypad support
  */
 void input_init(void);
 
+/**
+ * Initialize input without curses: switch a terminal descriptor to
+ * unbuffered, unechoed, non-blocking reads and decode its raw bytes
+ * (for the ANSI render backend). input_cleanup restores the terminal.
+ * @param fd Terminal descriptor (usually STDIN_FILENO)
+ * @return false if fd is not a terminal
+ */
+bool input_init_raw(int fd);
+
 /**
  * Poll for keyboard input
  * Returns immediately if no key is pressed (non-blocking)
@@ -33,6 +57,37 @@ void input_init(void);
  */
 InputAction input_poll(void);
 
+/**
+ * Drain every pending key in one call, so bursts of input never wait
+ * for later frames. Unrecognized keys are skipped.
+ * @param actions Array receiving the actions in arrival order
+ * @param max_actions Capacity of actions (keys beyond it stay queued)
+ * @return Number of actions written (0 if no key is pending)
+ */
+int input_poll_all(InputAction* actions, int max_actions);
+
+/**
+ * Initialize a byte-stream decoder (no partial sequence pending)
+ * @param decoder Pointer to decoder state
+ */
+void input_decoder_init(InputDecoder* decoder);
+
+/**
+ * Decode raw key bytes (VT100/xterm sequences, as sent by terminals and
+ * telnet clients) into actions, using the same key map as input_poll.
+ * Arrows arrive as ESC [ A-D or ESC O A-D; CR LF and CR NUL count as a
+ * single Enter. A sequence cut off at the end of bytes is completed by
+ * the next call.
+ * @param decoder Pointer to decoder state
+ * @param bytes Input bytes
+ * @param length Number of bytes
+ * @param actions Array receiving the actions in arrival order
+ * @param max_actions Capacity of actions (further keys are dropped)
+ * @return Number of actions written
+ */
+int input_decode(InputDecoder* decoder, const unsigned char* bytes, size_t length,
+                 InputAction* actions, int max_actions);
+
 /**
  * Cleanup input system
  * Restores terminal state
@@ -1,30 +1,67 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <pwd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <locale.h>
+#include <time.h>
+#include <unistd.h>
 #include "timing.h"
+#include "event.h"
 #include "input.h"
 #include "game.h"
 #include "render.h"
 #include "sound.h"
+#include "replay.h"
+#include "framestats.h"
+#include "server.h"
+#include "handoff.h"
+#include "scores.h"
+#include "metrics.h"
+#include "corpus.h"
 
 /**
  * main.c - Main entry point and game loop orchestration
  *
  * Coordinates all modules to run the Tetris game:
  * - Initializes timing, rendering, input, and game systems
- * - Runs main game loop at 60 FPS
+ * - Runs main game loop at 60 FPS, or event-driven (--event-loop), or
+ *   with drawing on its own thread (--threaded)
  * - Processes input and updates game state
  * - Renders game visuals
  * - Handles pause and game over states
+ * - Records sessions (--record) and verifies recordings (--replay),
+ *   optionally appending their placements to a training corpus (--corpus)
+ * - Times each frame phase (--debug-stats) and dumps histograms on exit
+ * - Keeps per-user, per-level best scores on disk (--scores FILE)
+ * - Exports process metrics as a Prometheus text file (--metrics-file FILE)
+ * - Draws through ncurses, or raw ANSI sequences with one write per frame (--ansi)
+ * - Hosts many network sessions in one process instead (--server PORT)
  * - Cleans up on exit
  */
 
+/* Input-to-lock timing of the local game (its metrics lock hook context) */
+static MetricsPieceClock piece_clock;
+
 /**
  * Handle input action by calling appropriate game function
+ * In-game actions are also logged to recorder (if recording) and start
+ * the piece's input-to-lock time
  */
-static void handle_input(Game* game, InputAction action, bool* should_quit, int* selected_level) {
+static void handle_input(Game* game, InputAction action, bool* should_quit,
+                         int* selected_level, ReplayWriter* recorder) {
+    if (recorder != NULL && game->state != GAME_STATE_START_SCREEN &&
+        action != INPUT_NONE && action != INPUT_QUIT && action != INPUT_START) {
+        replay_write_input(recorder, game->frame_count, action);
+    }
+    if (game->state == GAME_STATE_PLAYING && action != INPUT_NONE &&
+        action != INPUT_QUIT && action != INPUT_START && action != INPUT_PAUSE) {
+        metrics_note_input(&piece_clock);
+    }
+
     switch (action) {
         case INPUT_LEFT:
             if (game->state == GAME_STATE_START_SCREEN) {
@@ -34,7 +71,7 @@ static void handle_input(Game* game, InputAction action, bool* should_quit, int*
                     *selected_level = 10;  /* Wrap around */
                 }
             } else {
-                game_move_left(game);
+                game_shift_press(game, -1);
             }
             break;
         case INPUT_RIGHT:
@@ -45,7 +82,7 @@ static void handle_input(Game* game, InputAction action, bool* should_quit, int*
                     *selected_level = 1;  /* Wrap around */
                 }
             } else {
-                game_move_right(game);
+                game_shift_press(game, 1);
             }
             break;
         case INPUT_DOWN:
@@ -90,6 +127,9 @@ static void handle_input(Game* game, InputAction action, bool* should_quit, int*
             if (game->state == GAME_STATE_START_SCREEN) {
                 /* Start game with selected level */
                 game_set_starting_level(game, *selected_level);
+                if (recorder != NULL) {
+                    replay_write_start(recorder, *selected_level);
+                }
             }
             break;
         case INPUT_NONE:
@@ -98,6 +138,386 @@ static void handle_input(Game* game, InputAction action, bool* should_quit, int*
     }
 }
 
+/**
+ * Record the time since start for a phase (if measuring)
+ * @return Current time, the start of the next phase (0 if not measuring)
+ */
+static double phase_end(FrameStats* stats, FramePhase phase, double start) {
+    if (stats == NULL) {
+        return 0.0;
+    }
+
+    double now = timer_get_time();
+    frame_stats_record(stats, phase, now - start);
+    return now;
+}
+
+/**
+ * Record how far a wake-up missed its deadline (positive = late)
+ */
+static void record_wake_error(FrameStats* stats, double error) {
+    if (stats == NULL || error == 0.0) {
+        return;
+    }
+
+    if (error > 0.0) {
+        frame_stats_record(stats, FRAME_PHASE_OVERSLEEP, error);
+    } else {
+        frame_stats_record(stats, FRAME_PHASE_UNDERSLEEP, -error);
+    }
+}
+
+/**
+ * End a paced frame: count it (and how far it overran its deadline, if
+ * it did) in the metrics registry, then sleep out the rest of it
+ */
+static void wait_frame(Timer* timer, FrameStats* stats) {
+    if (!timer->fixed_step) {
+        double late = timer_get_time() - timer->last_frame_time -
+                      timer->target_frame_duration;
+        metrics_add(METRIC_FRAMES, 1);
+        if (late > 0.0) {
+            metrics_add(METRIC_FRAME_OVERRUNS, 1);
+            metrics_observe(METRIC_HIST_FRAME_OVERRUN, (uint64_t)(late * 1e6));
+        }
+    }
+
+    record_wake_error(stats, timer_wait_frame(timer));
+}
+
+/**
+ * Submit a finished game to the score table once, on its first game over
+ * frame (before that frame is drawn or published, so the overlay shows
+ * the updated table)
+ */
+static void record_score(ScoreTable* scores, const Game* game, int selected_level,
+                         bool* recorded) {
+    if (scores == NULL || *recorded || !game_is_over(game)) {
+        return;
+    }
+
+    *recorded = true;
+    if (!scores_submit(scores, selected_level, game_get_score(game),
+                       game_get_lines(game))) {
+        fprintf(stderr, "ntris: %s: could not save score\n", scores->path);
+    }
+}
+
+/**
+ * Draw one frame for the current state
+ * Begin (clear on scene change) → Draw game → Draw stats → Draw overlays →
+ * Refresh. Only what changed since the last frame is emitted
+ */
+static void render_frame(Renderer* renderer, const Game* game, int selected_level,
+                         FrameStats* stats) {
+    double start = stats != NULL ? timer_get_time() : 0.0;
+
+    render_begin_frame(renderer, game, selected_level);
+
+    if (game->state == GAME_STATE_START_SCREEN) {
+        /* Draw start screen with level selection */
+        render_draw_start_screen(renderer, selected_level);
+    } else {
+        /* Draw normal game */
+        render_draw_game(renderer, game);
+        render_draw_stats(renderer, game);
+        if (stats != NULL) {
+            render_draw_debug(renderer, stats);
+        }
+
+        /* Draw pause overlay if paused */
+        if (game_is_paused(game)) {
+            render_draw_pause(renderer);
+        }
+
+        /* Draw game over screen if game ended */
+        if (game_is_over(game)) {
+            render_draw_game_over(renderer, game);
+        }
+    }
+
+    double drawn = phase_end(stats, FRAME_PHASE_RENDER, start);
+    render_refresh(renderer);
+    phase_end(stats, FRAME_PHASE_REFRESH, drawn);
+}
+
+/**
+ * Fixed-rate loop: input → update → render → sleep, 60 times a second
+ */
+static void run_frame_loop(Timer* timer, Renderer* renderer, Game* game,
+                           ReplayWriter* recorder, FrameStats* stats,
+                           ScoreTable* scores) {
+    bool should_quit = false;
+    bool score_recorded = false;
+    int selected_level = 1;  /* Default starting level */
+
+    /* Main game loop - runs until quit requested */
+    while (!should_quit) {
+        /* Compute delta time BEFORE resetting frame timer */
+        double delta = timer_get_delta(timer);
+        timer_start_frame(timer);
+        double phase_start = stats != NULL ? timer_get_time() : 0.0;
+
+        /* INPUT PHASE: Apply every key that arrived since the last frame */
+        InputAction actions[INPUT_BATCH_SIZE];
+        int count = input_poll_all(actions, INPUT_BATCH_SIZE);
+        for (int i = 0; i < count && !should_quit; i++) {
+            handle_input(game, actions[i], &should_quit, &selected_level, recorder);
+        }
+        phase_start = phase_end(stats, FRAME_PHASE_INPUT, phase_start);
+
+        /* UPDATE PHASE: Convert elapsed real time to whole game frames */
+        int frames = timer_consume_frames(timer, delta);
+        if (!game_is_paused(game) && game->state != GAME_STATE_START_SCREEN) {
+            game_update(game, frames);
+        }
+        record_score(scores, game, selected_level, &score_recorded);
+        phase_end(stats, FRAME_PHASE_UPDATE, phase_start);
+
+        /* RENDER PHASE */
+        render_frame(renderer, game, selected_level, stats);
+
+        /* TIMING PHASE: Wait for remaining frame time to maintain 60 FPS */
+        wait_frame(timer, stats);
+    }
+}
+
+/**
+ * Event-driven loop: sleep until a key arrives or the game's next gravity
+ * or lock-delay deadline, then catch the game up and redraw. Sessions on
+ * the start screen, paused or at game over sleep until input.
+ */
+static void run_event_loop(Timer* timer, Renderer* renderer, Game* game,
+                           ReplayWriter* recorder, FrameStats* stats,
+                           ScoreTable* scores) {
+    EventLoop events;
+    if (!event_init(&events, STDIN_FILENO)) {
+        run_frame_loop(timer, renderer, game, recorder, stats, scores);  /* No timerfd */
+        return;
+    }
+
+    bool should_quit = false;
+    bool score_recorded = false;
+    int selected_level = 1;  /* Default starting level */
+
+    render_frame(renderer, game, selected_level, stats);
+
+    while (!should_quit) {
+        /* WAIT PHASE: Deadline is the next frame on which the game changes */
+        double timeout = -1.0;
+        int event_frames = game_frames_until_event(game);
+        if (event_frames > 0) {
+            timeout = (double)event_frames * timer->target_frame_duration -
+                      timer->frame_accumulator;
+            if (timeout < 0.0) {
+                timeout = 0.0;
+            }
+        }
+        double wait_start = stats != NULL ? timer_get_time() : 0.0;
+        int ready = event_wait(&events, timeout);
+        double phase_start = stats != NULL ? timer_get_time() : 0.0;
+        if (ready == EVENT_TIMER) {
+            /* Woke for the deadline alone: measure how close it was */
+            record_wake_error(stats, phase_start - (wait_start + timeout));
+        }
+
+        /* UPDATE PHASE: Step the frames that elapsed while asleep (before
+         * applying input, so keys act on the state they were pressed in) */
+        double elapsed = timer_get_elapsed(timer);
+        timer_start_frame(timer);
+        int frames = timer_consume_frames(timer, elapsed);
+        if (!game_is_paused(game) && game->state != GAME_STATE_START_SCREEN) {
+            game_update(game, frames);
+        }
+        record_score(scores, game, selected_level, &score_recorded);
+        phase_start = phase_end(stats, FRAME_PHASE_UPDATE, phase_start);
+
+        /* INPUT PHASE: Apply every pending key */
+        InputAction actions[INPUT_BATCH_SIZE];
+        int count;
+        while (!should_quit &&
+               (count = input_poll_all(actions, INPUT_BATCH_SIZE)) > 0) {
+            for (int i = 0; i < count && !should_quit; i++) {
+                handle_input(game, actions[i], &should_quit, &selected_level, recorder);
+            }
+        }
+        if (ready & EVENT_HANGUP) {
+            should_quit = true;  /* Terminal gone: poll would never sleep again */
+        }
+        phase_end(stats, FRAME_PHASE_INPUT, phase_start);
+
+        /* RENDER PHASE */
+        render_frame(renderer, game, selected_level, stats);
+    }
+
+    event_cleanup(&events);
+}
+
+/* Render thread state (--threaded) */
+typedef struct {
+    Renderer* renderer;
+    FrameHandoff* handoff;
+    FrameStats* stats;  /* Render-side phases, NULL if not measuring */
+} RenderThread;
+
+/**
+ * Render thread: draw the newest published frame until the last one
+ */
+static void* render_thread_main(void* arg) {
+    RenderThread* thread = (RenderThread*)arg;
+
+    for (;;) {
+        const HandoffFrame* frame = handoff_wait(thread->handoff);
+
+        /* Panel shows the simulation's phases next to this thread's own */
+        if (thread->stats != NULL) {
+            for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+                if (p != FRAME_PHASE_RENDER && p != FRAME_PHASE_REFRESH) {
+                    thread->stats->phases[p] = frame->stats.phases[p];
+                }
+            }
+        }
+
+        render_frame(thread->renderer, &frame->game, frame->selected_level,
+                     thread->stats);
+        if (frame->quit) {
+            return NULL;
+        }
+    }
+}
+
+/**
+ * Publish the current state for the render thread
+ */
+static void publish_frame(FrameHandoff* handoff, const Game* game, int selected_level,
+                          bool quit, const FrameStats* stats) {
+    HandoffFrame* frame = handoff_back(handoff);
+    frame->game = *game;
+    frame->selected_level = selected_level;
+    frame->quit = quit;
+    if (stats != NULL) {
+        frame->stats = *stats;
+    }
+    handoff_publish(handoff);
+}
+
+/**
+ * Threaded loop: this thread runs input → update → publish at a fixed
+ * 60 Hz while a render thread draws the newest published state, so a
+ * stalled terminal write delays only the picture, never gravity or input.
+ * Input is read raw (input_init_raw) because curses is not thread-safe
+ * and belongs to the render thread.
+ */
+static void run_threaded_loop(Timer* timer, Renderer* renderer, Game* game,
+                              ReplayWriter* recorder, FrameStats* stats,
+                              ScoreTable* scores) {
+    static FrameHandoff handoff;
+    static FrameStats render_stats;
+    RenderThread thread = {renderer, &handoff, stats != NULL ? &render_stats : NULL};
+    pthread_t render_thread;
+
+    if (stats != NULL) {
+        frame_stats_init(&render_stats);
+    }
+    bool started = handoff_init(&handoff);
+    if (started && pthread_create(&render_thread, NULL, render_thread_main, &thread) != 0) {
+        handoff_cleanup(&handoff);
+        started = false;
+    }
+    if (!started) {
+        run_frame_loop(timer, renderer, game, recorder, stats, scores);  /* Single-threaded */
+        return;
+    }
+
+    bool should_quit = false;
+    bool score_recorded = false;
+    int selected_level = 1;  /* Default starting level */
+
+    while (!should_quit) {
+        double delta = timer_get_delta(timer);
+        timer_start_frame(timer);
+        double phase_start = stats != NULL ? timer_get_time() : 0.0;
+
+        /* INPUT PHASE */
+        InputAction actions[INPUT_BATCH_SIZE];
+        int count = input_poll_all(actions, INPUT_BATCH_SIZE);
+        for (int i = 0; i < count && !should_quit; i++) {
+            handle_input(game, actions[i], &should_quit, &selected_level, recorder);
+        }
+        phase_start = phase_end(stats, FRAME_PHASE_INPUT, phase_start);
+
+        /* UPDATE PHASE */
+        int frames = timer_consume_frames(timer, delta);
+        if (!game_is_paused(game) && game->state != GAME_STATE_START_SCREEN) {
+            game_update(game, frames);
+        }
+        record_score(scores, game, selected_level, &score_recorded);
+        phase_end(stats, FRAME_PHASE_UPDATE, phase_start);
+
+        /* PUBLISH PHASE: hand the state over without waiting for the drawing */
+        publish_frame(&handoff, game, selected_level, should_quit, stats);
+
+        wait_frame(timer, stats);
+    }
+
+    pthread_join(render_thread, NULL);
+    handoff_cleanup(&handoff);
+
+    /* Exit dump: render-side phases come from the render thread */
+    if (stats != NULL) {
+        stats->phases[FRAME_PHASE_RENDER] = render_stats.phases[FRAME_PHASE_RENDER];
+        stats->phases[FRAME_PHASE_REFRESH] = render_stats.phases[FRAME_PHASE_REFRESH];
+    }
+}
+
+/**
+ * Play a recording back headless and report whether it reproduces,
+ * appending one record per locked piece to corpus_path if given
+ * @return Process exit status (failure on unreadable file, mismatch or
+ *         corpus write error)
+ */
+static int run_replay(const char* path, const char* corpus_path) {
+    static CorpusWriter corpus;
+    if (corpus_path != NULL && !corpus_writer_open(&corpus, corpus_path)) {
+        fprintf(stderr, "ntris: %s: cannot append to corpus\n", corpus_path);
+        return EXIT_FAILURE;
+    }
+
+    ReplayResult result;
+    bool played = replay_play(path, &result, corpus_path != NULL ? corpus_lock_hook : NULL,
+                              &corpus);
+    if (corpus_path != NULL && !corpus_writer_close(&corpus)) {
+        fprintf(stderr, "ntris: %s: corpus write failed\n", corpus_path);
+        return EXIT_FAILURE;
+    }
+    if (!played) {
+        fprintf(stderr, "ntris: %s: not a complete ntris recording\n", path);
+        return EXIT_FAILURE;
+    }
+
+    bool matches = replay_result_matches(&result);
+    printf("seed %llu level %d inputs %u\n",
+           (unsigned long long)result.seed, result.starting_level, result.inputs);
+    printf("frames %u (recorded %u)\n", result.frames, result.expected_frames);
+    printf("score %d (recorded %d)\n", result.score, result.expected_score);
+    printf("lines %d (recorded %d)\n", result.lines, result.expected_lines);
+    printf("%s\n", matches ? "OK" : "MISMATCH");
+    return matches ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Name scores are saved under: $USER, else the login name
+ */
+static const char* player_name(void) {
+    const char* user = getenv("USER");
+    if (user != NULL && user[0] != '\0') {
+        return user;
+    }
+
+    struct passwd* entry = getpwuid(getuid());
+    return entry != NULL ? entry->pw_name : "player";
+}
+
 /**
  * Main entry point
  */
@@ -105,77 +525,175 @@ int main(int argc, char** argv) {
     /* Initialize locale for UTF-8 support */
     setlocale(LC_ALL, "");
 
-    /* Handle --version flag */
+    /* Handle command-line flags */
+    bool uncapped = false;    /* Fixed-step mode: no frame limiting */
+    bool event_loop = false;  /* Sleep until input or next game deadline */
+    const char* record_path = NULL;
+    bool debug_stats = false;  /* Frame phase timing panel and exit dump */
+    bool ansi = false;         /* Raw escape-sequence renderer instead of ncurses */
+    bool threaded = false;     /* Simulation and rendering on separate threads */
+    const char* scores_path = NULL;  /* Default: ~/.ntris_scores */
+    const char* metrics_path = NULL;  /* Prometheus text file */
+    const char* server_port = NULL;   /* Host sessions instead of playing */
+    const char* replay_path = NULL;   /* Verify a recording instead of playing */
+    const char* corpus_path = NULL;   /* Training corpus fed by --replay */
     if (argc > 1) {
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "--version") == 0) {
                 printf("ntris version 1.0\n");
                 printf("NES-style Tetris clone for Linux terminal\n");
                 return EXIT_SUCCESS;
+            } else if (strcmp(argv[i], "--uncapped") == 0) {
+                uncapped = true;
+            } else if (strcmp(argv[i], "--event-loop") == 0) {
+                event_loop = true;
+            } else if (strcmp(argv[i], "--threaded") == 0) {
+                threaded = true;
+            } else if (strcmp(argv[i], "--ansi") == 0) {
+                ansi = true;
+            } else if (strcmp(argv[i], "--debug-stats") == 0) {
+                debug_stats = true;
+            } else if (strcmp(argv[i], "--scores") == 0 && i + 1 < argc) {
+                scores_path = argv[++i];
+            } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                record_path = argv[++i];
+            } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+                replay_path = argv[++i];
+            } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+                corpus_path = argv[++i];
+            } else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc) {
+                metrics_path = argv[++i];
+            } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+                server_port = argv[++i];
             }
         }
     }
 
+    if (replay_path != NULL) {
+        return run_replay(replay_path, corpus_path);  /* Headless, no terminal setup */
+    }
+
+    /* Exported from a background thread; the frame loop only adds to
+     * counters */
+    if (metrics_path != NULL && !metrics_start_export(metrics_path)) {
+        fprintf(stderr, "ntris: %s: could not start metrics export\n", metrics_path);
+        return EXIT_FAILURE;
+    }
+
+    if (server_port != NULL) {
+        bool served = server_run(atoi(server_port));
+        if (!served) {
+            perror("ntris: server");
+        }
+        metrics_stop_export();
+        return served ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     /* Initialize all modules */
     Timer timer;
     Renderer renderer;
     Game game;
+    uint64_t seed = (uint64_t)time(NULL);
 
-    timer_init(&timer, 60);  /* 60 FPS target */
-    render_init(&renderer);
-    input_init();
-    game_init(&game);
-
-    /* Game loop control */
-    bool should_quit = false;
-    int selected_level = 1;  /* Default starting level */
-
-    /* Main game loop - runs until quit requested */
-    while (!should_quit) {
-        /* Compute delta time BEFORE resetting frame timer */
-        double delta = timer_get_delta(&timer);
-        timer_start_frame(&timer);
-
-        /* INPUT PHASE: Poll keyboard and map to game actions */
-        InputAction action = input_poll();
-        handle_input(&game, action, &should_quit, &selected_level);
-
-        /* UPDATE PHASE: Update game state with delta time */
-        if (!game_is_paused(&game) && game.state != GAME_STATE_START_SCREEN) {
-            game_update(&game, delta);
+    /* Open recording before touching the terminal so errors are visible */
+    static ReplayWriter recording;
+    ReplayWriter* recorder = NULL;
+    if (record_path != NULL) {
+        if (!replay_writer_open(&recording, record_path, seed)) {
+            perror(record_path);
+            return EXIT_FAILURE;
         }
+        recorder = &recording;
+    }
 
-        /* RENDER PHASE: Clear → Draw game → Draw stats → Draw overlays → Refresh */
-        render_clear(&renderer);
-
-        if (game.state == GAME_STATE_START_SCREEN) {
-            /* Draw start screen with level selection */
-            render_draw_start_screen(&renderer, selected_level);
+    /* A broken score file costs the leaderboard, not the game */
+    static ScoreTable score_table;
+    ScoreTable* scores = NULL;
+    char default_scores[4096];
+    const char* home = getenv("HOME");
+    if (scores_path == NULL && home != NULL && home[0] != '\0') {
+        /* Board size variants keep their own leaderboards */
+        if (BOARD_WIDTH != 10 || BOARD_HEIGHT != 20) {
+            snprintf(default_scores, sizeof(default_scores), "%s/.ntris_scores_%dx%d",
+                     home, BOARD_WIDTH, BOARD_HEIGHT);
         } else {
-            /* Draw normal game */
-            render_draw_game(&renderer, &game);
-            render_draw_stats(&renderer, &game);
-
-            /* Draw pause overlay if paused */
-            if (game_is_paused(&game)) {
-                render_draw_pause(&renderer);
-            }
+            snprintf(default_scores, sizeof(default_scores), "%s/.ntris_scores", home);
+        }
+        scores_path = default_scores;
+    }
+    if (scores_path != NULL) {
+        if (scores_open(&score_table, scores_path, player_name())) {
+            scores = &score_table;
+        } else {
+            fprintf(stderr, "ntris: %s: not a score file, scores not saved\n",
+                    scores_path);
+        }
+    }
 
-            /* Draw game over screen if game ended */
-            if (game_is_over(&game)) {
-                render_draw_game_over(&renderer, &game);
-            }
+    if (uncapped) {
+        timer_init_fixed(&timer, GAME_FRAME_RATE);  /* One game frame per loop, no sleep */
+    } else {
+        timer_init(&timer, GAME_FRAME_RATE);  /* 60 FPS target */
+    }
+    if (ansi) {
+        if (!input_init_raw(STDIN_FILENO)) {
+            fprintf(stderr, "ntris: --ansi needs a terminal on stdin\n");
+            return EXIT_FAILURE;
+        }
+        if (!render_init_ansi(&renderer, STDOUT_FILENO, 0, 0)) {
+            input_cleanup();
+            fprintf(stderr, "ntris: out of memory\n");
+            return EXIT_FAILURE;
+        }
+    } else {
+        render_init(&renderer);
+        if (!threaded || !input_init_raw(STDIN_FILENO)) {
+            input_init();
+            threaded = false;  /* getch() must stay on the drawing thread */
         }
+    }
 
-        render_refresh(&renderer);
+    FrameStats frame_stats;
+    FrameStats* stats = NULL;
+    if (debug_stats) {
+        frame_stats_init(&frame_stats);
+        render_set_debug_panel(&renderer, true);
+        stats = &frame_stats;
+    }
+    game_init_seeded(&game, seed);
+    if (metrics_exporting()) {
+        game_set_lock_hook(&game, metrics_lock_hook, &piece_clock, false);
+    }
+    render_set_scores(&renderer, scores);
 
-        /* TIMING PHASE: Wait for remaining frame time to maintain 60 FPS */
-        timer_wait_frame(&timer);
+    /* Run until quit requested (uncapped mode never sleeps, so it always
+     * uses the frame loop) */
+    if (threaded) {
+        run_threaded_loop(&timer, &renderer, &game, recorder, stats, scores);
+    } else if (event_loop && !uncapped) {
+        run_event_loop(&timer, &renderer, &game, recorder, stats, scores);
+    } else {
+        run_frame_loop(&timer, &renderer, &game, recorder, stats, scores);
     }
 
-    /* Cleanup all modules on exit */
-    render_cleanup(&renderer);
+    /* Cleanup all modules on exit (input first: raw mode restores the
+     * terminal settings it found, which endwin then resets) */
     input_cleanup();
+    render_cleanup(&renderer);
+    if (scores != NULL) {
+        scores_close(scores);
+    }
+    metrics_stop_export();
+
+    /* Terminal is restored, so the dump lands in the normal scrollback */
+    if (stats != NULL) {
+        frame_stats_dump(stats, stderr);
+    }
+
+    if (recorder != NULL && !replay_writer_close(recorder, &game)) {
+        fprintf(stderr, "ntris: %s: recording incomplete\n", record_path);
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,194 @@
+#include "match.h"
+#include <stdlib.h>
+
+/* Garbage rows sent for clearing 0-4 lines */
+static const uint8_t ATTACK_ROWS[5] = {0, 0, 1, 2, 4};
+
+/* Seed offset between consecutive matches */
+#define MATCH_SEED_STEP 0x9E3779B97F4A7C15ULL
+
+bool match_init(MatchEngine* engine, size_t num_matches, int players,
+                uint64_t seed, int starting_level) {
+    engine->num_matches = num_matches;
+    engine->players = players;
+    engine->num_games = num_matches * (size_t)players;
+
+    size_t n = engine->num_games;
+    engine->games = calloc(n, sizeof(*engine->games));
+    engine->pending = calloc(n, sizeof(*engine->pending));
+    engine->sent = calloc(n, sizeof(*engine->sent));
+    engine->target = calloc(n, sizeof(*engine->target));
+    engine->locks_seen = calloc(n, sizeof(*engine->locks_seen));
+    engine->actions = calloc(n, sizeof(*engine->actions));
+    engine->garbage_rng = calloc(num_matches, sizeof(*engine->garbage_rng));
+    engine->frames = calloc(num_matches, sizeof(*engine->frames));
+    engine->winner = calloc(num_matches, sizeof(*engine->winner));
+
+    if (players < 2 || players > MATCH_MAX_PLAYERS || num_matches == 0 ||
+        engine->games == NULL || engine->pending == NULL || engine->sent == NULL ||
+        engine->target == NULL || engine->locks_seen == NULL ||
+        engine->actions == NULL || engine->garbage_rng == NULL ||
+        engine->frames == NULL || engine->winner == NULL) {
+        match_destroy(engine);
+        return false;
+    }
+
+    for (size_t m = 0; m < num_matches; m++) {
+        uint64_t match_seed = seed + m * MATCH_SEED_STEP;
+        rng_seed(&engine->garbage_rng[m], ~match_seed);
+        engine->winner[m] = MATCH_RUNNING;
+
+        for (int seat = 0; seat < players; seat++) {
+            size_t i = m * (size_t)players + (size_t)seat;
+            game_init_seeded(&engine->games[i], match_seed);
+            game_set_starting_level(&engine->games[i], starting_level);
+            engine->target[i] = (uint8_t)((seat + 1) % players);
+        }
+    }
+
+    return true;
+}
+
+/* Resolve this frame's locks of one match: attacks, cancelling and
+ * incoming garbage, then retarget and check for a winner */
+static void resolve_match(MatchEngine* engine, size_t m) {
+    int players = engine->players;
+    size_t base = m * (size_t)players;
+
+    for (int seat = 0; seat < players; seat++) {
+        size_t i = base + (size_t)seat;
+        const Game* game = &engine->games[i];
+        if (game->pieces_locked == engine->locks_seen[i]) {
+            continue;
+        }
+        int lines = BOARD_ROWSET_COUNT(game->last_cleared_rows);
+        engine->locks_seen[i] = game->pieces_locked;
+
+        /* Attack cancels own queued garbage first, the rest is sent */
+        int attack = ATTACK_ROWS[lines];
+        int cancelled = attack < engine->pending[i] ? attack : engine->pending[i];
+        engine->pending[i] = (uint16_t)(engine->pending[i] - cancelled);
+        attack -= cancelled;
+        if (attack > 0) {
+            engine->pending[base + engine->target[i]] =
+                (uint16_t)(engine->pending[base + engine->target[i]] + attack);
+            engine->sent[i] += (uint32_t)attack;
+        }
+
+        /* A lock without clears lets queued garbage in */
+        if (lines == 0 && engine->pending[i] > 0) {
+            int rows = engine->pending[i] < MATCH_MAX_GARBAGE_PER_LOCK
+                           ? engine->pending[i] : MATCH_MAX_GARBAGE_PER_LOCK;
+            engine->pending[i] = (uint16_t)(engine->pending[i] - rows);
+            int hole = (int)rng_range(&engine->garbage_rng[m], BOARD_WIDTH);
+            game_receive_garbage(&engine->games[i], rows, hole);
+        }
+    }
+
+    /* Survivors attack the next live seat; one survivor wins */
+    int alive = 0;
+    int last_alive = MATCH_DRAW;
+    for (int seat = 0; seat < players; seat++) {
+        size_t i = base + (size_t)seat;
+        if (engine->games[i].state != GAME_STATE_PLAYING) {
+            continue;
+        }
+        alive++;
+        last_alive = seat;
+
+        int target = engine->target[i];
+        while (target == seat ||
+               engine->games[base + (size_t)target].state != GAME_STATE_PLAYING) {
+            target = (target + 1) % players;
+            if (target == seat) {
+                break;
+            }
+        }
+        engine->target[i] = (uint8_t)target;
+    }
+    if (alive <= 1) {
+        engine->winner[m] = (int8_t)last_alive;
+    }
+}
+
+void match_step(MatchEngine* engine, const Action* actions) {
+    int players = engine->players;
+
+    for (size_t m = 0; m < engine->num_matches; m++) {
+        if (engine->winner[m] != MATCH_RUNNING) {
+            continue;
+        }
+
+        size_t base = m * (size_t)players;
+        for (int seat = 0; seat < players; seat++) {
+            Game* game = &engine->games[base + (size_t)seat];
+            if (game->state != GAME_STATE_PLAYING) {
+                continue;
+            }
+            if (actions != NULL) {
+                game_apply_action(game, &actions[base + (size_t)seat]);
+            }
+            game_step_frame(game);
+        }
+
+        resolve_match(engine, m);
+        engine->frames[m]++;
+    }
+}
+
+void match_rollout(MatchEngine* engine, BatchPolicy policy, void* ctx, int max_frames) {
+    for (int frame = 0; max_frames <= 0 || frame < max_frames; frame++) {
+        bool running = false;
+
+        for (size_t m = 0; m < engine->num_matches; m++) {
+            if (engine->winner[m] != MATCH_RUNNING) {
+                continue;
+            }
+            running = true;
+
+            size_t base = m * (size_t)engine->players;
+            for (int seat = 0; seat < engine->players; seat++) {
+                size_t i = base + (size_t)seat;
+                if (engine->games[i].state == GAME_STATE_PLAYING) {
+                    engine->actions[i] = policy(&engine->games[i], ctx);
+                }
+            }
+        }
+        if (!running) {
+            return;
+        }
+
+        match_step(engine, engine->actions);
+    }
+}
+
+int match_winner(const MatchEngine* engine, size_t match) {
+    return engine->winner[match];
+}
+
+const Game* match_get_game(const MatchEngine* engine, size_t match, int seat) {
+    return &engine->games[match * (size_t)engine->players + (size_t)seat];
+}
+
+void match_destroy(MatchEngine* engine) {
+    free(engine->games);
+    free(engine->pending);
+    free(engine->sent);
+    free(engine->target);
+    free(engine->locks_seen);
+    free(engine->actions);
+    free(engine->garbage_rng);
+    free(engine->frames);
+    free(engine->winner);
+    engine->games = NULL;
+    engine->pending = NULL;
+    engine->sent = NULL;
+    engine->target = NULL;
+    engine->locks_seen = NULL;
+    engine->actions = NULL;
+    engine->garbage_rng = NULL;
+    engine->frames = NULL;
+    engine->winner = NULL;
+    engine->num_matches = 0;
+    engine->num_games = 0;
+}
@@ -0,0 +1,114 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "batch.h"
+#include "game.h"
+
+/**
+ * match.h - Versus matches with garbage, many at once
+ *
+ * A MatchEngine holds any number of independent matches of the same
+ * size (1v1 or N players). All per-player state lives in parallel
+ * arrays indexed by match * players + seat: the Games themselves in one
+ * contiguous array, next to columns for queued garbage, garbage sent,
+ * attack target and locks already resolved. Per-match columns hold the
+ * garbage hole generator, frame count and outcome. match_step walks the
+ * columns once per frame for every match, so thousands of matches can
+ * be stepped per core for matchmaking calibration.
+ *
+ * Rules: clearing 2 / 3 / 4 lines sends 1 / 2 / 4 garbage rows, first
+ * cancelling garbage queued against the sender. Queued garbage is pushed
+ * in (at most MATCH_MAX_GARBAGE_PER_LOCK rows, one hole column per batch)
+ * when its receiver locks a piece without clearing. Each player attacks
+ * the next seat still in the match. Players in one match get the same
+ * piece sequence.
+ *
+ * Locks are detected from each Game's pieces_locked counter, so the
+ * games need no lock hook and can carry one of their own.
+ */
+
+#define MATCH_MAX_PLAYERS 8
+#define MATCH_MAX_GARBAGE_PER_LOCK 8
+
+/* Match outcome (otherwise the winning seat) */
+#define MATCH_RUNNING -1
+#define MATCH_DRAW -2  /* Last players topped out on the same frame */
+
+typedef struct {
+    size_t num_matches;
+    int players;       /* Seats per match */
+    size_t num_games;  /* num_matches * players */
+
+    /* Per player (index match * players + seat) */
+    Game* games;
+    uint16_t* pending;     /* Garbage rows queued against the player */
+    uint32_t* sent;        /* Garbage rows sent after cancelling */
+    uint8_t* target;       /* Seat this player attacks */
+    uint32_t* locks_seen;  /* Game.pieces_locked when last resolved */
+    Action* actions;       /* Scratch for match_rollout */
+
+    /* Per match */
+    Rng* garbage_rng;      /* Hole columns */
+    uint32_t* frames;      /* Frames played */
+    int8_t* winner;        /* MATCH_RUNNING, MATCH_DRAW or winning seat */
+} MatchEngine;
+
+/**
+ * Allocate matches and start every game at the given level.
+ *
+ * @param engine Pointer to engine structure
+ * @param num_matches Number of matches
+ * @param players Seats per match (2 to MATCH_MAX_PLAYERS)
+ * @param seed Base seed (match m plays seed-derived pieces and holes)
+ * @param starting_level Level every player starts at (1-10)
+ * @return false if players is out of range or memory ran out
+ */
+bool match_init(MatchEngine* engine, size_t num_matches, int players,
+                uint64_t seed, int starting_level);
+
+/**
+ * Advance every running match by one frame: apply actions[i] to player
+ * i and step its game, then resolve attacks and garbage and decide
+ * finished matches.
+ *
+ * @param engine Pointer to initialized engine
+ * @param actions One action per player (NULL = no input)
+ */
+void match_step(MatchEngine* engine, const Action* actions);
+
+/**
+ * Play every match to the end (or max_frames), asking the policy for
+ * each live player's action every frame.
+ *
+ * @param engine Pointer to initialized engine
+ * @param policy Action chooser
+ * @param ctx Opaque pointer passed to policy
+ * @param max_frames Per-match frame limit (<= 0 for no limit)
+ */
+void match_rollout(MatchEngine* engine, BatchPolicy policy, void* ctx, int max_frames);
+
+/**
+ * Get a match's outcome.
+ *
+ * @param engine Pointer to initialized engine
+ * @param match Match index
+ * @return MATCH_RUNNING, MATCH_DRAW or the winning seat
+ */
+int match_winner(const MatchEngine* engine, size_t match);
+
+/**
+ * Get a player's game (index match * players + seat).
+ */
+const Game* match_get_game(const MatchEngine* engine, size_t match, int seat);
+
+/**
+ * Free the engine's arrays.
+ *
+ * @param engine Pointer to initialized engine
+ */
+void match_destroy(MatchEngine* engine);
+
+#endif /* MATCH_H */
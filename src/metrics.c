@@ -0,0 +1,242 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "metrics.h"
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "framestats.h"
+#include "timing.h"
+
+/* Prometheus name and help text of a metric */
+typedef struct {
+    const char* name;
+    const char* help;
+} MetricInfo;
+
+/* Histogram export: values are scaled into the base unit (seconds) */
+typedef struct {
+    const char* name;
+    const char* help;
+    double scale;
+} HistogramInfo;
+
+static const MetricInfo COUNTER_INFO[METRIC_COUNTER_COUNT] = {
+    {"ntris_pieces_locked_total", "Pieces locked."},
+    {"ntris_lines_cleared_total", "Lines cleared."},
+    {"ntris_tetrises_total", "Locks that cleared four lines."},
+    {"ntris_frames_total", "Frames paced by the frame timer."},
+    {"ntris_frame_overruns_total", "Frames that ran past their deadline."},
+    {"ntris_render_frames_total", "Frames refreshed on the ANSI renderer."},
+    {"ntris_render_bytes_total", "Bytes of terminal output produced."}
+};
+
+static const HistogramInfo HISTOGRAM_INFO[METRIC_HISTOGRAM_COUNT] = {
+    {"ntris_input_to_lock_seconds", "Time from a piece's first input to its lock.", 1e-6},
+    {"ntris_frame_overrun_seconds", "How late overrunning frames were.", 1e-6},
+    {"ntris_render_frame_bytes", "Terminal output bytes per ANSI frame.", 1.0}
+};
+
+typedef struct {
+    uint64_t sum;
+    uint64_t buckets[METRICS_BUCKETS];
+} MetricsHistogramData;
+
+/* The registry (every field updated with relaxed atomics) */
+static uint64_t counters[METRIC_COUNTER_COUNT];
+static MetricsHistogramData histograms[METRIC_HISTOGRAM_COUNT];
+
+/* Exporter thread */
+static struct {
+    bool running;
+    const char* path;
+    pthread_t thread;
+    sem_t stop;  /* Posted by metrics_stop_export */
+    double start_time;
+    double last_time;       /* Previous export, for the pieces/s gauge */
+    uint64_t last_pieces;
+} exporter;
+
+/* Add to a counter */
+void metrics_add(MetricCounter counter, uint64_t amount) {
+    __atomic_fetch_add(&counters[counter], amount, __ATOMIC_RELAXED);
+}
+
+/* Record one observation into its log2 bucket */
+void metrics_observe(MetricHistogram histogram, uint64_t value) {
+    int bucket = frame_stats_bucket(value, METRICS_BUCKETS);
+    MetricsHistogramData* data = &histograms[histogram];
+    __atomic_fetch_add(&data->buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&data->sum, value, __ATOMIC_RELAXED);
+}
+
+/* Read a counter */
+uint64_t metrics_get(MetricCounter counter) {
+    return __atomic_load_n(&counters[counter], __ATOMIC_RELAXED);
+}
+
+/* Start the piece's input-to-lock time on its first input */
+void metrics_note_input(MetricsPieceClock* clock) {
+    if (clock->first_input == 0.0) {
+        clock->first_input = timer_get_time();
+    }
+}
+
+/* Count one lock */
+void metrics_lock_hook(const Game* game, const GameLockEvent* event, void* ctx) {
+    (void)game;
+
+    metrics_add(METRIC_PIECES_LOCKED, 1);
+    if (event->lines > 0) {
+        metrics_add(METRIC_LINES_CLEARED, (uint64_t)event->lines);
+    }
+    if (event->lines == 4) {
+        metrics_add(METRIC_TETRISES, 1);
+    }
+
+    /* Pieces locked without any input (gravity alone) are not timed */
+    MetricsPieceClock* clock = (MetricsPieceClock*)ctx;
+    if (clock != NULL && clock->first_input != 0.0) {
+        double elapsed = timer_get_time() - clock->first_input;
+        metrics_observe(METRIC_HIST_INPUT_TO_LOCK, (uint64_t)(elapsed * 1e6));
+        clock->first_input = 0.0;
+    }
+}
+
+/* Write one histogram (cumulative buckets; count is the +Inf bucket, so
+ * the two always agree) */
+static void write_histogram(FILE* out, MetricHistogram histogram) {
+    const HistogramInfo* info = &HISTOGRAM_INFO[histogram];
+    const MetricsHistogramData* data = &histograms[histogram];
+
+    fprintf(out, "# HELP %s %s\n# TYPE %s histogram\n", info->name, info->help, info->name);
+    uint64_t cumulative = 0;
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        cumulative += __atomic_load_n(&data->buckets[i], __ATOMIC_RELAXED);
+        if (i < METRICS_BUCKETS - 1) {
+            fprintf(out, "%s_bucket{le=\"%g\"} %llu\n", info->name,
+                    (double)(2ULL << i) * info->scale, (unsigned long long)cumulative);
+        }
+    }
+    fprintf(out, "%s_bucket{le=\"+Inf\"} %llu\n", info->name, (unsigned long long)cumulative);
+    fprintf(out, "%s_sum %g\n", info->name,
+            (double)__atomic_load_n(&data->sum, __ATOMIC_RELAXED) * info->scale);
+    fprintf(out, "%s_count %llu\n", info->name, (unsigned long long)cumulative);
+}
+
+/* Write the registry to path via a temporary file and rename, with the
+ * exporter's interval gauges if asked (exporter thread only) */
+static bool write_registry(const char* path, bool gauges) {
+    size_t tmp_length = strlen(path) + 32;
+    char* tmp_path = malloc(tmp_length);
+    if (tmp_path == NULL) {
+        return false;
+    }
+    snprintf(tmp_path, tmp_length, "%s.tmp.%ld", path, (long)getpid());
+
+    FILE* out = fopen(tmp_path, "w");
+    if (out == NULL) {
+        free(tmp_path);
+        return false;
+    }
+
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        const MetricInfo* info = &COUNTER_INFO[i];
+        fprintf(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", info->name, info->help,
+                info->name, info->name,
+                (unsigned long long)metrics_get((MetricCounter)i));
+    }
+    for (int i = 0; i < METRIC_HISTOGRAM_COUNT; i++) {
+        write_histogram(out, (MetricHistogram)i);
+    }
+
+    /* Rate over the last export interval */
+    if (gauges) {
+        double now = timer_get_time();
+        uint64_t pieces = metrics_get(METRIC_PIECES_LOCKED);
+        double interval = now - exporter.last_time;
+        double rate = interval > 0.0 ? (double)(pieces - exporter.last_pieces) / interval : 0.0;
+        exporter.last_time = now;
+        exporter.last_pieces = pieces;
+
+        fprintf(out, "# HELP ntris_pieces_per_second Pieces locked per second since "
+                     "the previous export.\n# TYPE ntris_pieces_per_second gauge\n"
+                     "ntris_pieces_per_second %g\n", rate);
+        fprintf(out, "# HELP ntris_uptime_seconds Seconds since the exporter started.\n"
+                     "# TYPE ntris_uptime_seconds gauge\nntris_uptime_seconds %g\n",
+                now - exporter.start_time);
+    }
+
+    bool ok = !ferror(out);
+    ok = fclose(out) == 0 && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok) {
+        unlink(tmp_path);
+    }
+    free(tmp_path);
+    return ok;
+}
+
+/* Write the registry in Prometheus text format */
+bool metrics_write(const char* path) {
+    return write_registry(path, false);
+}
+
+/* Exporter thread: write, then sleep until the next interval or stop */
+static void* export_main(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += METRICS_EXPORT_INTERVAL;
+
+        int result;
+        while ((result = sem_timedwait(&exporter.stop, &deadline)) != 0 && errno == EINTR) {
+        }
+        write_registry(exporter.path, true);
+        if (result == 0) {
+            return NULL;  /* Stopped: that was the final snapshot */
+        }
+    }
+}
+
+/* Start the exporter thread */
+bool metrics_start_export(const char* path) {
+    if (exporter.running || sem_init(&exporter.stop, 0, 0) != 0) {
+        return false;
+    }
+
+    exporter.path = path;
+    exporter.start_time = timer_get_time();
+    exporter.last_time = exporter.start_time;
+    exporter.last_pieces = metrics_get(METRIC_PIECES_LOCKED);
+    exporter.running = true;
+    if (pthread_create(&exporter.thread, NULL, export_main, NULL) != 0) {
+        exporter.running = false;
+        sem_destroy(&exporter.stop);
+        return false;
+    }
+    return true;
+}
+
+/* Stop the exporter after a final snapshot */
+void metrics_stop_export(void) {
+    if (!exporter.running) {
+        return;
+    }
+
+    sem_post(&exporter.stop);
+    pthread_join(exporter.thread, NULL);
+    sem_destroy(&exporter.stop);
+    exporter.running = false;
+}
+
+/* Check whether the exporter is running */
+bool metrics_exporting(void) {
+    return exporter.running;
+}
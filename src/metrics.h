@@ -0,0 +1,121 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game.h"
+
+/**
+ * metrics.h - Process-wide counters and histograms for fleet monitoring
+ *
+ * One registry per process. The game (through its lock hook, installed
+ * only while exporting), the frame loops and the renderer update it
+ * with relaxed atomic adds, so any
+ * thread may record without locks and a record costs a few uncontended
+ * instructions. An optional exporter thread periodically writes the
+ * registry as a Prometheus text file (--metrics-file), e.g. into
+ * node_exporter's textfile collector directory; the file is replaced by
+ * rename, so a scrape never sees a partial snapshot.
+ *
+ * Values are read individually, not as one consistent snapshot: a
+ * histogram may be one observation ahead of a counter updated with it.
+ */
+
+/* Histogram bucket i holds values in [2^i, 2^(i+1)) (bucket 0 also
+ * holds 0; the last holds the rest), placed by frame_stats_bucket */
+#define METRICS_BUCKETS 21
+
+/* Seconds between exports */
+#define METRICS_EXPORT_INTERVAL 10
+
+typedef enum {
+    METRIC_PIECES_LOCKED,   /* Pieces locked, every game */
+    METRIC_LINES_CLEARED,   /* Lines cleared */
+    METRIC_TETRISES,        /* Locks clearing four lines */
+    METRIC_FRAMES,          /* Frames paced by the frame timer or server tick */
+    METRIC_FRAME_OVERRUNS,  /* Of those, frames that ran past their deadline */
+    METRIC_RENDER_FRAMES,   /* render_refresh calls on the ANSI backend */
+    METRIC_RENDER_BYTES,    /* Escape-sequence bytes they produced */
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+typedef enum {
+    METRIC_HIST_INPUT_TO_LOCK,  /* Microseconds from a piece's first input to its lock */
+    METRIC_HIST_FRAME_OVERRUN,  /* Microseconds an overrunning frame was late */
+    METRIC_HIST_RENDER_BYTES,   /* Bytes per ANSI frame */
+    METRIC_HISTOGRAM_COUNT
+} MetricHistogram;
+
+/* Per-game input-to-lock timing (the lock hook's context) */
+typedef struct {
+    double first_input;  /* Time of the current piece's first input, 0 = none */
+} MetricsPieceClock;
+
+/**
+ * Add to a counter.
+ *
+ * @param counter Counter to update
+ * @param amount Amount added
+ */
+void metrics_add(MetricCounter counter, uint64_t amount);
+
+/**
+ * Record one histogram observation.
+ *
+ * @param histogram Histogram to update
+ * @param value Observation, in the histogram's unit
+ */
+void metrics_observe(MetricHistogram histogram, uint64_t value);
+
+/**
+ * Read a counter.
+ */
+uint64_t metrics_get(MetricCounter counter);
+
+/**
+ * Note an input to a game's current piece (the first one starts its
+ * input-to-lock time).
+ *
+ * @param clock The game's piece clock
+ */
+void metrics_note_input(MetricsPieceClock* clock);
+
+/**
+ * Lock hook counting pieces, lines and tetrises (install with
+ * game_set_lock_hook, without the board: it is not read).
+ *
+ * @param game Game that locked a piece
+ * @param event Lock details
+ * @param ctx The game's MetricsPieceClock, or NULL to skip latency
+ */
+void metrics_lock_hook(const Game* game, const GameLockEvent* event, void* ctx);
+
+/**
+ * Write the registry in Prometheus text format, replacing path.
+ *
+ * @param path Output file
+ * @return false if the file could not be written
+ */
+bool metrics_write(const char* path);
+
+/**
+ * Start exporting to path every METRICS_EXPORT_INTERVAL seconds from a
+ * background thread.
+ *
+ * @param path Output file (must outlive the exporter)
+ * @return false if the exporter thread could not be started
+ */
+bool metrics_start_export(const char* path);
+
+/**
+ * Stop the exporter after writing a final snapshot (no-op if not started).
+ */
+void metrics_stop_export(void);
+
+/**
+ * Check whether the exporter is running (games only need the metrics
+ * lock hook then).
+ */
+bool metrics_exporting(void);
+
+#endif /* METRICS_H */
@@ -0,0 +1,27 @@
+#ifndef NTRIS_H
+#define NTRIS_H
+
+/**
+ * ntris.h - Public API of the headless simulation library (libntris)
+ *
+ * Single include for embedding ntris game logic without the ncurses
+ * front end. Everything reachable from here lives in libntris.a /
+ * libntris.so and has no terminal, TTY or global-state dependency:
+ * each Game is self-contained, so any number of them can be simulated
+ * in one process.
+ */
+
+#include "rng.h"
+#include "arena.h"
+#include "piece.h"
+#include "board.h"
+#include "game.h"
+#include "batch.h"
+#include "corpus.h"
+#include "match.h"
+
+/* Library API version (bumped on incompatible changes to these headers) */
+#define NTRIS_VERSION_MAJOR 2
+#define NTRIS_VERSION_MINOR 0
+
+#endif /* NTRIS_H */
@@ -131,6 +131,16 @@ static const char* const PIECE_NAMES[PIECE_COUNT] = {
     "L-piece"
 };
 
+/* Wall kick offsets for rotation attempts (Simple Rotation System) */
+static const PieceKick WALL_KICK_OFFSETS[PIECE_KICK_COUNT] = {
+    {0, 0},   /* No offset */
+    {-1, 0},  /* Left 1 */
+    {1, 0},   /* Right 1 */
+    {0, -1},  /* Up 1 */
+    {-2, 0},  /* Left 2 (for I-piece) */
+    {2, 0}    /* Right 2 (for I-piece) */
+};
+
 /* Public API implementations */
 
 const PieceShape* piece_get_shape(PieceType type, RotationState rotation) {
@@ -143,6 +153,10 @@ const PieceShape* piece_get_shape(PieceType type, RotationState rotation) {
     return &ROTATION_TABLES[type][rotation];
 }
 
+const PieceKick* piece_get_kicks(void) {
+    return WALL_KICK_OFFSETS;
+}
+
 int piece_get_color(PieceType type) {
     if (type < 0 || type >= PIECE_COUNT) {
         return 0;  /* Return 0 for invalid piece */
@@ -1,6 +1,8 @@
 #ifndef PIECE_H
 #define PIECE_H
 
+#include <stdint.h>
+
 /* Tetromino piece definitions, shapes, colors, and rotation logic */
 
 /* Piece types (7 standard Tetrominos) */
@@ -28,9 +30,36 @@ typedef struct {
     int cells[4][2];  /* [block_index][x/y] - 4 blocks, each with x,y coordinate */
 } PieceShape;
 
+/* Derived per-rotation lookup data over the same 4x4 grid as PieceShape
+ * Generated at build time from the shape tables (see piece_tables.h) */
+typedef struct {
+    uint16_t rows[4];   /* Row bitmasks: bit x of rows[y] set for block {x, y} */
+    int8_t bottom[4];   /* Lowest filled y per grid column, -1 if column empty */
+    int8_t min_x;       /* Bounding box of the filled cells */
+    int8_t max_x;
+    int8_t min_y;
+    int8_t max_y;
+} PieceInfo;
+
+/* Wall kick offset tried when rotating (Simple Rotation System) */
+typedef struct {
+    int8_t dx;
+    int8_t dy;
+} PieceKick;
+
+/* Number of kick candidates tried per rotation, in order */
+#define PIECE_KICK_COUNT 6
+
 /* Get piece shape for given type and rotation state */
 const PieceShape* piece_get_shape(PieceType type, RotationState rotation);
 
+/* Get precomputed masks and extents for given type and rotation state */
+const PieceInfo* piece_get_info(PieceType type, RotationState rotation);
+
+/* Get wall kick table (PIECE_KICK_COUNT entries, first is no offset)
+ * A rotation takes the first candidate that does not collide */
+const PieceKick* piece_get_kicks(void);
+
 /* Get ncurses color pair for piece type (1-7) */
 int piece_get_color(PieceType type);
 
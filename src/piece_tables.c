@@ -0,0 +1,14 @@
+#include "piece_tables.h"
+#include <stddef.h>
+
+/* Derived lookup tables (generated into piece_tables.h at build time) */
+
+const PieceInfo* piece_get_info(PieceType type, RotationState rotation) {
+    if (type < 0 || type >= PIECE_COUNT) {
+        return NULL;
+    }
+    if (rotation < ROT_0 || rotation > ROT_270) {
+        return NULL;
+    }
+    return &PIECE_INFO[type][rotation];
+}
@@ -1,11 +1,51 @@
 #include "render.h"
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "metrics.h"
 
 /* Window layout constants */
 #define BOARD_DISPLAY_WIDTH (BOARD_WIDTH * 2)  /* Each cell is 2 chars wide */
 #define BOARD_DISPLAY_HEIGHT BOARD_HEIGHT
+#define MENU_WIDTH 20  /* Widest line of the start screen */
+#define GAME_PANEL_WIDTH (BOARD_DISPLAY_WIDTH > MENU_WIDTH ? BOARD_DISPLAY_WIDTH : MENU_WIDTH)
+#define BOARD_DISPLAY_X (1 + (GAME_PANEL_WIDTH - BOARD_DISPLAY_WIDTH) / 2)  /* Narrow boards are centered */
 #define STATS_PANEL_WIDTH 20
 #define NEXT_PIECE_HEIGHT 8
+#define RENDER_PREVIEW_COUNT 3  /* Upcoming pieces shown (see game_peek_piece) */
+#define STATS_VALUE_WIDTH (STATS_PANEL_WIDTH - 4)  /* Width values are padded to */
+#define COMPACT_LABEL_WIDTH 6  /* Label column of the compact stats layout */
+#define DEBUG_PANEL_INTERVAL (GAME_FRAME_RATE / 2)  /* Rendered frames per panel update */
+
+/* Short row labels of the timing panel, in FramePhase order */
+static const char* const DEBUG_LABELS[FRAME_PHASE_COUNT] = {
+    "in", "upd", "draw", "refr", "late", "early"
+};
+
+/* Encoded contents of a board cell in the last drawn frame */
+#define CELL_EMPTY 0        /* 1-8 = block of that color (8 = garbage) */
+#define CELL_GHOST 0x10     /* OR'd with ghost piece color */
+#define CELL_UNKNOWN 0xFF   /* Not drawn since last clear */
+
+/* Compute panel positions (board centered, stats panel to its right) */
+static void compute_layout(Renderer* renderer, int lines, int cols) {
+    int start_y = (lines - BOARD_DISPLAY_HEIGHT - 2) / 2;  /* -2 for borders */
+    int start_x = (cols - GAME_PANEL_WIDTH - STATS_PANEL_WIDTH - 6) / 2;  /* -6 for borders */
+
+    renderer->rects[RENDER_WIN_GAME] = (RenderRect){
+        start_y, start_x, BOARD_DISPLAY_HEIGHT + 2, GAME_PANEL_WIDTH + 2
+    };
+    renderer->rects[RENDER_WIN_STATS] = (RenderRect){
+        start_y, start_x + GAME_PANEL_WIDTH + 3, BOARD_DISPLAY_HEIGHT + 2,
+        STATS_PANEL_WIDTH
+    };
+    renderer->rects[RENDER_WIN_NEXT] = (RenderRect){
+        start_y + 1, start_x + GAME_PANEL_WIDTH + 4, NEXT_PIECE_HEIGHT,
+        STATS_PANEL_WIDTH - 2
+    };
+}
 
 /* Initialize ncurses and create windows */
 void render_init(Renderer* renderer) {
@@ -28,168 +68,414 @@ void render_init(Renderer* renderer) {
         init_pair(5, COLOR_RED, COLOR_BLACK);     /* Z piece */
         init_pair(6, COLOR_BLUE, COLOR_BLACK);    /* J piece */
         init_pair(7, COLOR_WHITE, COLOR_BLACK);   /* L piece (orange approximated as white) */
+        init_pair(BOARD_GARBAGE_COLOR, COLOR_WHITE, COLOR_BLACK);  /* Restored cells */
 
         /* Store color pairs */
-        for (int i = 0; i < 8; i++) {
+        for (int i = 0; i <= BOARD_GARBAGE_COLOR; i++) {
             renderer->color_pairs[i] = i;
         }
     }
 
-    /* Calculate window positions (center game board) */
-    int start_y = (LINES - BOARD_DISPLAY_HEIGHT - 2) / 2;  /* -2 for borders */
-    int start_x = (COLS - BOARD_DISPLAY_WIDTH - STATS_PANEL_WIDTH - 6) / 2;  /* -6 for borders */
+    /* Create game board, stats and next piece preview windows */
+    renderer->backend = RENDER_BACKEND_CURSES;
+    renderer->output_fd = -1;
+    compute_layout(renderer, LINES, COLS);
+    for (int i = 0; i < RENDER_WIN_COUNT; i++) {
+        const RenderRect* rect = &renderer->rects[i];
+        renderer->windows[i] = newwin(rect->height, rect->width, rect->top, rect->left);
+    }
+
+    renderer->scene = -1;
+    renderer->debug_panel = false;
+    renderer->scores = NULL;
+    renderer->selected_level = 1;
+    render_clear(renderer);
+}
+
+/* Initialize the ANSI backend */
+bool render_init_ansi(Renderer* renderer, int output_fd, int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        struct winsize size;
+        bool known = output_fd >= 0 && ioctl(output_fd, TIOCGWINSZ, &size) == 0 &&
+                     size.ws_row > 0 && size.ws_col > 0;
+        rows = known ? size.ws_row : 24;
+        cols = known ? size.ws_col : 80;
+    }
+    if (!ansi_screen_init(&renderer->screen, rows, cols)) {
+        return false;
+    }
+
+    renderer->backend = RENDER_BACKEND_ANSI;
+    renderer->output_fd = output_fd;
+    for (int i = 0; i <= BOARD_GARBAGE_COLOR; i++) {
+        renderer->color_pairs[i] = i;
+    }
+    for (int i = 0; i < RENDER_WIN_COUNT; i++) {
+        renderer->windows[i] = NULL;
+    }
+    compute_layout(renderer, rows, cols);
+
+    /* Own terminal: alternate screen and hidden cursor */
+    static const char enter[] = "\033[?1049h\033[?25l";
+    if (output_fd >= 0) {
+        ansi_screen_emit(&renderer->screen, enter, sizeof(enter) - 1);
+    }
+
+    renderer->scene = -1;
+    renderer->debug_panel = false;
+    renderer->scores = NULL;
+    renderer->selected_level = 1;
+    render_clear(renderer);
+    return true;
+}
+
+/* Bytes produced by the ANSI backend without an output descriptor */
+const char* render_get_output(const Renderer* renderer, size_t* length) {
+    *length = renderer->screen.out_len;
+    return renderer->screen.out;
+}
+
+/* Drop output bytes the caller has sent */
+void render_consume_output(Renderer* renderer, size_t length) {
+    ansi_screen_consume(&renderer->screen, length);
+}
+
+/* Text attribute for the curses backend */
+static attr_t curses_attr(uint8_t attr) {
+    attr_t result = 0;
+    if (attr & ANSI_ATTR_COLOR_MASK) {
+        result |= COLOR_PAIR(attr & ANSI_ATTR_COLOR_MASK);
+    }
+    if (attr & ANSI_ATTR_DIM) {
+        result |= A_DIM;
+    }
+    if (attr & ANSI_ATTR_REVERSE) {
+        result |= A_REVERSE;
+    }
+    return result;
+}
+
+/* Draw constant text in a panel (attr = color | ANSI_ATTR_* flags) */
+static void put_text(Renderer* renderer, RenderWindow win, int y, int x,
+                     uint8_t attr, const char* text) {
+    if (renderer->backend == RENDER_BACKEND_ANSI) {
+        const RenderRect* rect = &renderer->rects[win];
+        ansi_screen_put(&renderer->screen, rect->top + y, rect->left + x, attr,
+                        text, strlen(text));
+        return;
+    }
+
+    WINDOW* window = renderer->windows[win];
+    attr_t curses = curses_attr(attr);
+    if (curses != 0) {
+        wattron(window, curses);
+    }
+    mvwaddstr(window, y, x, text);
+    if (curses != 0) {
+        wattroff(window, curses);
+    }
+}
+
+/* Draw formatted text in a panel */
+static void put_textf(Renderer* renderer, RenderWindow win, int y, int x,
+                      uint8_t attr, const char* format, ...) {
+    char text[64];
+    va_list args;
 
-    /* Create game board window */
-    renderer->game_win = newwin(BOARD_DISPLAY_HEIGHT + 2, BOARD_DISPLAY_WIDTH + 2,
-                                start_y, start_x);
-    box(renderer->game_win, 0, 0);
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
 
-    /* Create stats window (to the right of game board) */
-    renderer->stats_win = newwin(BOARD_DISPLAY_HEIGHT + 2, STATS_PANEL_WIDTH,
-                                 start_y, start_x + BOARD_DISPLAY_WIDTH + 3);
-    box(renderer->stats_win, 0, 0);
+    put_text(renderer, win, y, x, attr, text);
+}
 
-    /* Create next piece preview window (top of stats panel) */
-    renderer->next_win = newwin(NEXT_PIECE_HEIGHT, STATS_PANEL_WIDTH - 2,
-                                start_y + 1, start_x + BOARD_DISPLAY_WIDTH + 4);
-    box(renderer->next_win, 0, 0);
+/* Erase a panel and draw its border */
+static void erase_window(Renderer* renderer, RenderWindow win) {
+    if (renderer->backend == RENDER_BACKEND_CURSES) {
+        werase(renderer->windows[win]);
+        box(renderer->windows[win], 0, 0);
+        return;
+    }
+
+    const RenderRect* rect = &renderer->rects[win];
+    AnsiScreen* screen = &renderer->screen;
+    ansi_screen_fill(screen, rect->top, rect->left, 1, rect->width, '-', 0);
+    ansi_screen_fill(screen, rect->top + rect->height - 1, rect->left, 1,
+                     rect->width, '-', 0);
+    ansi_screen_fill(screen, rect->top + 1, rect->left, rect->height - 2, 1, '|', 0);
+    ansi_screen_fill(screen, rect->top + 1, rect->left + rect->width - 1,
+                     rect->height - 2, 1, '|', 0);
+    ansi_screen_fill(screen, rect->top + 1, rect->left + 1, rect->height - 2,
+                     rect->width - 2, ' ', 0);
+    for (int corner = 0; corner < 4; corner++) {
+        int row = rect->top + (corner & 1 ? rect->height - 1 : 0);
+        int col = rect->left + (corner & 2 ? rect->width - 1 : 0);
+        ansi_screen_put(screen, row, col, 0, "+", 1);
+    }
 }
 
-/* Clear screen */
+/* Clear screen and forget the last drawn frame */
 void render_clear(Renderer* renderer) {
-    werase(renderer->game_win);
-    werase(renderer->stats_win);
-    werase(renderer->next_win);
-    box(renderer->game_win, 0, 0);
-    box(renderer->stats_win, 0, 0);
-    box(renderer->next_win, 0, 0);
+    for (int i = 0; i < RENDER_WIN_COUNT; i++) {
+        erase_window(renderer, (RenderWindow)i);
+    }
+
+    /* Boards narrower than the panel get their own side walls */
+    if (BOARD_DISPLAY_X > 1) {
+        for (int y = 1; y <= BOARD_DISPLAY_HEIGHT; y++) {
+            put_text(renderer, RENDER_WIN_GAME, y, BOARD_DISPLAY_X - 1, 0, "|");
+            put_text(renderer, RENDER_WIN_GAME, y, BOARD_DISPLAY_X + BOARD_DISPLAY_WIDTH,
+                     0, "|");
+        }
+    }
+
+    memset(renderer->drawn_cells, CELL_UNKNOWN, sizeof(renderer->drawn_cells));
+    renderer->drawn_score = -1;
+    renderer->drawn_high_score = -1;
+    renderer->drawn_level = -1;
+    renderer->drawn_debug_epoch = UINT64_MAX;
+    renderer->drawn_lines = -1;
+    renderer->drawn_next = -1;
+    renderer->labels_drawn = false;
+    renderer->overlay_drawn = false;
 }
 
-/* Helper function to draw a cell with color */
-static void draw_cell(WINDOW* win, int y, int x, int color) {
-    if (color > 0 && color <= 7) {
-        wattron(win, COLOR_PAIR(color));
-        mvwprintw(win, y, x, "[]");
-        wattroff(win, COLOR_PAIR(color));
+/* Begin a frame, clearing only on scene change */
+void render_begin_frame(Renderer* renderer, const Game* game, int selected_level) {
+    int scene = (int)game->state;
+    if (game->state == GAME_STATE_START_SCREEN) {
+        scene |= selected_level << 4;
+    }
+
+    if (scene != renderer->scene) {
+        render_clear(renderer);
+        renderer->scene = scene;
+    }
+    renderer->selected_level = selected_level;
+}
+
+/* Draw a board cell given its frame encoding */
+static void draw_encoded_cell(Renderer* renderer, int y, int x, uint8_t code) {
+    if (code & CELL_GHOST) {
+        int color = code & ~CELL_GHOST;
+        put_text(renderer, RENDER_WIN_GAME, y, x, (uint8_t)(color | ANSI_ATTR_DIM), "..");
+    } else if (code > 0 && code <= BOARD_GARBAGE_COLOR) {
+        put_text(renderer, RENDER_WIN_GAME, y, x, code, "[]");
     } else {
         /* Empty cell - two spaces */
-        mvwprintw(win, y, x, "  ");
+        put_text(renderer, RENDER_WIN_GAME, y, x, 0, "  ");
     }
 }
 
-/* Draw entire game board with current piece */
+/* Write a piece into a frame buffer (clipped to board bounds) */
+static void compose_piece(uint8_t frame[BOARD_HEIGHT][BOARD_WIDTH],
+                          const PieceShape* shape, int x, int y, uint8_t code) {
+    for (int i = 0; i < 4; i++) {
+        int px = x + shape->cells[i][0];
+        int py = y + shape->cells[i][1];
+
+        /* Only draw if within board bounds */
+        if (px >= 0 && px < BOARD_WIDTH && py >= 0 && py < BOARD_HEIGHT) {
+            frame[py][px] = code;
+        }
+    }
+}
+
+/* Draw entire game board with current piece (changed cells only) */
 void render_draw_game(Renderer* renderer, const Game* game) {
-    /* Draw locked pieces from board */
+    uint8_t frame[BOARD_HEIGHT][BOARD_WIDTH];
+
+    /* Compose frame: locked pieces from board */
     for (int y = 0; y < BOARD_HEIGHT; y++) {
         for (int x = 0; x < BOARD_WIDTH; x++) {
-            int cell = board_get_cell(&game->board, x, y);
-            draw_cell(renderer->game_win, y + 1, x * 2 + 1, cell);
+            frame[y][x] = (uint8_t)board_get_cell(&game->board, x, y);
         }
     }
 
-    /* Draw ghost piece if game is playing */
+    /* Ghost piece and current piece if game is playing */
     if (game->state == GAME_STATE_PLAYING) {
+        const PieceShape* shape = piece_get_shape(game->current_piece,
+                                                   game->current_rotation);
+        int color = piece_get_color(game->current_piece);
         int ghost_y = game_get_ghost_y(game);
 
         /* Only draw ghost if it's different from current piece position */
-        if (ghost_y != game->piece_y) {
-            const PieceShape* shape = piece_get_shape(game->current_piece,
-                                                       game->current_rotation);
-            int color = piece_get_color(game->current_piece);
-
-            for (int i = 0; i < 4; i++) {
-                int px = game->piece_x + shape->cells[i][0];
-                int py = ghost_y + shape->cells[i][1];
-
-                /* Only draw if within board bounds */
-                if (px >= 0 && px < BOARD_WIDTH && py >= 0 && py < BOARD_HEIGHT) {
-                    /* Draw ghost with dim color */
-                    if (color > 0 && color <= 7) {
-                        wattron(renderer->game_win, COLOR_PAIR(color) | A_DIM);
-                        mvwprintw(renderer->game_win, py + 1, px * 2 + 1, "..");
-                        wattroff(renderer->game_win, COLOR_PAIR(color) | A_DIM);
-                    }
-                }
-            }
+        if (ghost_y != game->piece_y && color > 0 && color <= 7) {
+            compose_piece(frame, shape, game->piece_x, ghost_y,
+                          (uint8_t)(CELL_GHOST | color));
         }
+        compose_piece(frame, shape, game->piece_x, game->piece_y, (uint8_t)color);
     }
 
-    /* Draw current piece if game is playing */
-    if (game->state == GAME_STATE_PLAYING) {
-        const PieceShape* shape = piece_get_shape(game->current_piece,
-                                                   game->current_rotation);
-        int color = piece_get_color(game->current_piece);
-
-        for (int i = 0; i < 4; i++) {
-            int px = game->piece_x + shape->cells[i][0];
-            int py = game->piece_y + shape->cells[i][1];
+    /* Nothing changed since last frame */
+    if (memcmp(frame, renderer->drawn_cells, sizeof(frame)) == 0) {
+        return;
+    }
 
-            /* Only draw if within board bounds */
-            if (px >= 0 && px < BOARD_WIDTH && py >= 0 && py < BOARD_HEIGHT) {
-                draw_cell(renderer->game_win, py + 1, px * 2 + 1, color);
+    /* Emit changed cells only */
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            if (frame[y][x] != renderer->drawn_cells[y][x]) {
+                draw_encoded_cell(renderer, y + 1, BOARD_DISPLAY_X + x * 2, frame[y][x]);
+                renderer->drawn_cells[y][x] = frame[y][x];
             }
         }
     }
 }
 
-/* Draw UI panels (score, level, lines, next piece preview) */
-void render_draw_stats(Renderer* renderer, const Game* game) {
-    /* Draw next piece preview */
-    mvwprintw(renderer->next_win, 0, 2, "NEXT");
+/* Redraw a stats value if it changed (padded to erase stale digits) */
+static void draw_stat_value(Renderer* renderer, int y, int x, int width, int value,
+                            int* drawn) {
+    if (value != *drawn) {
+        put_textf(renderer, RENDER_WIN_STATS, y, x, 0, "%-*d", width, value);
+        *drawn = value;
+    }
+}
 
-    if (game->state != GAME_STATE_GAME_OVER) {
-        const PieceShape* next_shape = piece_get_shape(game->next_piece, ROT_0);
-        int next_color = piece_get_color(game->next_piece);
+/* Draw one preview piece centered in a box of the preview window (each
+ * box is 2 rows tall, width in characters) */
+static void draw_preview_piece(Renderer* renderer, PieceType type, int top, int left,
+                               int width) {
+    const PieceShape* shape = piece_get_shape(type, ROT_0);
+    const PieceInfo* info = piece_get_info(type, ROT_0);
+    int color = piece_get_color(type);
+    int offset_x = left + (width - (info->max_x - info->min_x + 1) * 2) / 2;
+
+    if (color <= 0 || color > 7) {
+        return;
+    }
+    for (int i = 0; i < 4; i++) {
+        int px = (shape->cells[i][0] - info->min_x) * 2 + offset_x;
+        int py = shape->cells[i][1] - info->min_y + top;
+        put_text(renderer, RENDER_WIN_NEXT, py, px, (uint8_t)color, "[]");
+    }
+}
 
-        /* Center the next piece in preview window */
-        int offset_x = 6;  /* Horizontal centering */
-        int offset_y = 3;  /* Vertical centering */
+/* Draw UI panels (score, level, lines, next piece previews) */
+void render_draw_stats(Renderer* renderer, const Game* game) {
+    /* Draw upcoming pieces (hidden on game over): the next one centered
+     * on top, the two after it side by side below */
+    int next = -1;
+    if (game->state != GAME_STATE_GAME_OVER) {
+        next = 0;
+        for (int i = 0; i < RENDER_PREVIEW_COUNT; i++) {
+            next |= (int)game_peek_piece(game, i) << (3 * i);
+        }
+    }
+    if (next != renderer->drawn_next) {
+        erase_window(renderer, RENDER_WIN_NEXT);
+        put_text(renderer, RENDER_WIN_NEXT, 0, 2, 0, "NEXT");
+
+        if (next >= 0) {
+            int inner = STATS_PANEL_WIDTH - 4;  /* Preview window minus borders */
+            draw_preview_piece(renderer, game_peek_piece(game, 0), 1, 1, inner);
+            draw_preview_piece(renderer, game_peek_piece(game, 1), 4, 1, inner / 2);
+            draw_preview_piece(renderer, game_peek_piece(game, 2), 4, 1 + inner / 2,
+                               inner / 2);
+        }
 
-        for (int i = 0; i < 4; i++) {
-            int px = next_shape->cells[i][0] * 2 + offset_x;
-            int py = next_shape->cells[i][1] + offset_y;
+        renderer->drawn_next = next;
+    }
 
-            if (next_color > 0 && next_color <= 7) {
-                wattron(renderer->next_win, COLOR_PAIR(next_color));
-                mvwprintw(renderer->next_win, py, px, "[]");
-                wattroff(renderer->next_win, COLOR_PAIR(next_color));
-            }
+    /* Compact layout: one row per stat, directly below the preview */
+    if (renderer->debug_panel) {
+        int y = NEXT_PIECE_HEIGHT + 1;
+        int x = 2 + COMPACT_LABEL_WIDTH;
+        int width = STATS_VALUE_WIDTH - COMPACT_LABEL_WIDTH;
+        if (!renderer->labels_drawn) {
+            put_text(renderer, RENDER_WIN_STATS, y, 2, 0, "SCORE");
+            put_text(renderer, RENDER_WIN_STATS, y + 1, 2, 0, "HIGH");
+            put_text(renderer, RENDER_WIN_STATS, y + 2, 2, 0, "LEVEL");
+            put_text(renderer, RENDER_WIN_STATS, y + 3, 2, 0, "LINES");
+            renderer->labels_drawn = true;
         }
+
+        draw_stat_value(renderer, y, x, width, game->score,
+                        &renderer->drawn_score);
+        draw_stat_value(renderer, y + 1, x, width,
+                        game_get_session_high_score(game), &renderer->drawn_high_score);
+        draw_stat_value(renderer, y + 2, x, width, game->level,
+                        &renderer->drawn_level);
+        draw_stat_value(renderer, y + 3, x, width, game->lines_cleared,
+                        &renderer->drawn_lines);
+        return;
     }
 
     /* Draw stats below next piece preview */
     int stats_y = NEXT_PIECE_HEIGHT + 2;
-    mvwprintw(renderer->stats_win, stats_y, 2, "SCORE");
-    mvwprintw(renderer->stats_win, stats_y + 1, 2, "%d", game->score);
+    if (!renderer->labels_drawn) {
+        put_text(renderer, RENDER_WIN_STATS, stats_y, 2, 0, "SCORE");
+        put_text(renderer, RENDER_WIN_STATS, stats_y + 3, 2, 0, "HIGH SCORE");
+        put_text(renderer, RENDER_WIN_STATS, stats_y + 6, 2, 0, "LEVEL");
+        put_text(renderer, RENDER_WIN_STATS, stats_y + 9, 2, 0, "LINES");
+        renderer->labels_drawn = true;
+    }
 
-    mvwprintw(renderer->stats_win, stats_y + 3, 2, "HIGH SCORE");
-    mvwprintw(renderer->stats_win, stats_y + 4, 2, "%d", game_get_session_high_score(game));
+    draw_stat_value(renderer, stats_y + 1, 2, STATS_VALUE_WIDTH,
+                    game->score, &renderer->drawn_score);
+    draw_stat_value(renderer, stats_y + 4, 2, STATS_VALUE_WIDTH,
+                    game_get_session_high_score(game), &renderer->drawn_high_score);
+    draw_stat_value(renderer, stats_y + 7, 2, STATS_VALUE_WIDTH,
+                    game->level, &renderer->drawn_level);
+    draw_stat_value(renderer, stats_y + 10, 2, STATS_VALUE_WIDTH,
+                    game->lines_cleared, &renderer->drawn_lines);
+}
+
+/* Enable compact stats layout with timing panel */
+void render_set_debug_panel(Renderer* renderer, bool enabled) {
+    renderer->debug_panel = enabled;
+    render_clear(renderer);
+}
 
-    mvwprintw(renderer->stats_win, stats_y + 6, 2, "LEVEL");
-    mvwprintw(renderer->stats_win, stats_y + 7, 2, "%d", game->level);
+/* Show persistent leaderboards on the game over screen */
+void render_set_scores(Renderer* renderer, const ScoreTable* scores) {
+    renderer->scores = scores;
+}
 
-    mvwprintw(renderer->stats_win, stats_y + 9, 2, "LINES");
-    mvwprintw(renderer->stats_win, stats_y + 10, 2, "%d", game->lines_cleared);
+/* Draw frame timing panel below the compact stats */
+void render_draw_debug(Renderer* renderer, const FrameStats* stats) {
+    uint64_t epoch = stats->phases[FRAME_PHASE_REFRESH].count / DEBUG_PANEL_INTERVAL;
+    if (!renderer->debug_panel || epoch == renderer->drawn_debug_epoch) {
+        return;
+    }
+    renderer->drawn_debug_epoch = epoch;
+
+    int y = NEXT_PIECE_HEIGHT + 6;
+    put_textf(renderer, RENDER_WIN_STATS, y, 2, 0, "%-5s%5s%6s", "us", "avg", "max");
+    for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+        const FrameHistogram* histogram = &stats->phases[p];
+        double mean = frame_stats_mean(histogram) * 1e6;
+        double max = histogram->max * 1e6;
+        put_textf(renderer, RENDER_WIN_STATS, y + 1 + p, 2, 0, "%-5s%5.0f%6.0f",
+                  DEBUG_LABELS[p], mean < 99999.0 ? mean : 99999.0,
+                  max < 999999.0 ? max : 999999.0);
+    }
 }
 
 /* Draw start screen with level selection */
 void render_draw_start_screen(Renderer* renderer, int selected_level) {
+    /* Static screen: drawn once per scene (selected level is part of scene) */
+    if (renderer->overlay_drawn) {
+        return;
+    }
+    renderer->overlay_drawn = true;
+
     int center_y = BOARD_DISPLAY_HEIGHT / 2 - 5;
-    int center_x = BOARD_DISPLAY_WIDTH / 2;
+    int center_x = GAME_PANEL_WIDTH / 2;
 
     /* Draw title */
-    mvwprintw(renderer->game_win, center_y, center_x - 5, "N T R I S");
-    mvwprintw(renderer->game_win, center_y + 2, center_x - 9, "NES-style Tetris");
+    put_text(renderer, RENDER_WIN_GAME, center_y, center_x - 5, 0, "N T R I S");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 2, center_x - 9, 0, "NES-style Tetris");
 
     /* Draw controls */
-    mvwprintw(renderer->game_win, center_y + 5, center_x - 9, "CONTROLS");
-    mvwprintw(renderer->game_win, center_y + 6, 2, "Arrows: Move/Rotate");
-    mvwprintw(renderer->game_win, center_y + 7, 2, "Space:  Hard Drop");
-    mvwprintw(renderer->game_win, center_y + 8, 2, "P:      Pause");
-    mvwprintw(renderer->game_win, center_y + 9, 2, "Q:      Quit");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 5, center_x - 9, 0, "CONTROLS");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 6, 2, 0, "Arrows: Move/Rotate");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 7, 2, 0, "Space:  Hard Drop");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 8, 2, 0, "P:      Pause");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 9, 2, 0, "Q:      Quit");
 
     /* Draw level selection */
-    mvwprintw(renderer->game_win, center_y + 12, center_x - 9, "SELECT LEVEL (1-10)");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 12, center_x - 9, 0, "SELECT LEVEL (1-10)");
 
     /* Draw level options with highlight */
     int levels_per_row = 5;
@@ -202,73 +488,145 @@ void render_draw_start_screen(Renderer* renderer, int selected_level) {
 
         if (level == selected_level) {
             /* Highlight selected level */
-            wattron(renderer->game_win, A_REVERSE);
-            mvwprintw(renderer->game_win, y, x, "[%2d]", level);
-            wattroff(renderer->game_win, A_REVERSE);
+            put_textf(renderer, RENDER_WIN_GAME, y, x, ANSI_ATTR_REVERSE, "[%2d]", level);
         } else {
-            mvwprintw(renderer->game_win, y, x, " %2d ", level);
+            put_textf(renderer, RENDER_WIN_GAME, y, x, 0, " %2d ", level);
         }
     }
 
     /* Draw start instruction */
-    mvwprintw(renderer->game_win, center_y + 17, center_x - 9, "Press ENTER to start");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 17, center_x - 9, 0, "Press ENTER to start");
 }
 
 /* Draw pause overlay */
 void render_draw_pause(Renderer* renderer) {
+    /* Board is frozen while paused, so the overlay is drawn once */
+    if (renderer->overlay_drawn) {
+        return;
+    }
+    renderer->overlay_drawn = true;
+
     int center_y = BOARD_DISPLAY_HEIGHT / 2;
-    int center_x = BOARD_DISPLAY_WIDTH / 2;
+    int center_x = GAME_PANEL_WIDTH / 2;
 
     /* Draw pause message centered on game board */
-    mvwprintw(renderer->game_win, center_y, center_x - 3, "PAUSED");
-    mvwprintw(renderer->game_win, center_y + 2, center_x - 7, "Press P to resume");
+    put_text(renderer, RENDER_WIN_GAME, center_y, center_x - 3, 0, "PAUSED");
+    put_text(renderer, RENDER_WIN_GAME, center_y + 2, center_x - 7, 0, "Press P to resume");
 }
 
 /* Draw game over screen with final score and high score status */
 void render_draw_game_over(Renderer* renderer, const Game* game) {
+    /* Final state never changes, so the overlay is drawn once */
+    if (renderer->overlay_drawn) {
+        return;
+    }
+    renderer->overlay_drawn = true;
+
     int center_y = BOARD_DISPLAY_HEIGHT / 2;
-    int center_x = BOARD_DISPLAY_WIDTH / 2;
+    int center_x = GAME_PANEL_WIDTH / 2;
     int final_score = game_get_score(game);
     int high_score = game_get_session_high_score(game);
 
     /* Draw game over message centered on game board */
-    mvwprintw(renderer->game_win, center_y - 3, center_x - 5, "GAME OVER");
+    put_text(renderer, RENDER_WIN_GAME, center_y - 3, center_x - 5, 0, "GAME OVER");
 
-    mvwprintw(renderer->game_win, center_y - 1, center_x - 6, "Final Score:");
-    mvwprintw(renderer->game_win, center_y, center_x - 3, "%d", final_score);
+    put_text(renderer, RENDER_WIN_GAME, center_y - 1, center_x - 6, 0, "Final Score:");
+    put_textf(renderer, RENDER_WIN_GAME, center_y, center_x - 3, 0, "%d", final_score);
 
     /* Highlight if this is a new session high score */
     if (final_score == high_score && final_score > 0) {
-        mvwprintw(renderer->game_win, center_y + 1, center_x - 8, "NEW SESSION HIGH!");
+        put_text(renderer, RENDER_WIN_GAME, center_y + 1, center_x - 8, 0, "NEW SESSION HIGH!");
     } else {
-        mvwprintw(renderer->game_win, center_y + 1, center_x - 6, "High Score:");
-        mvwprintw(renderer->game_win, center_y + 2, center_x - 3, "%d", high_score);
+        put_text(renderer, RENDER_WIN_GAME, center_y + 1, center_x - 6, 0, "High Score:");
+        put_textf(renderer, RENDER_WIN_GAME, center_y + 2, center_x - 3, 0, "%d", high_score);
     }
 
-    mvwprintw(renderer->game_win, center_y + 4, center_x - 7, "Press Q to quit");
+    /* Leaderboard of the starting level: read in place from the mapping */
+    const ScoreTable* scores = renderer->scores;
+    if (scores != NULL) {
+        int level = renderer->selected_level;
+        size_t count;
+        const ScoreEntry* entries = scores_level(scores, level, &count);
+        /* This game against every other player's best */
+        size_t rank = 1;
+        size_t total = 1;
+        for (size_t i = 0; i < count; i++) {
+            if (strncmp(entries[i].user, scores->user, SCORES_USER_SIZE) != 0) {
+                total++;
+                rank += entries[i].score > (uint32_t)final_score;
+            }
+        }
+
+        put_textf(renderer, RENDER_WIN_GAME, center_y + 4, center_x - 7, 0,
+                  "LEVEL %d BEST", level);
+        if (count > 0) {
+            put_textf(renderer, RENDER_WIN_GAME, center_y + 5, center_x - 8, 0,
+                      "%-8.8s %8u", entries[0].user, (unsigned)entries[0].score);
+        }
+        put_textf(renderer, RENDER_WIN_GAME, center_y + 6, center_x - 8, 0,
+                  "Rank %zu of %zu", rank, total);
+        put_text(renderer, RENDER_WIN_GAME, center_y + 8, center_x - 7, 0, "Press Q to quit");
+        return;
+    }
+
+    put_text(renderer, RENDER_WIN_GAME, center_y + 4, center_x - 7, 0, "Press Q to quit");
 }
 
-/* Refresh display (call once per frame) */
+/* Refresh display (call once per frame)
+ * Curses: untouched windows are skipped by wnoutrefresh; doupdate with no
+ * pending changes writes nothing to the terminal. ANSI: the frame's
+ * changes go out in one write(), or stay buffered for the caller */
 void render_refresh(Renderer* renderer) {
-    wnoutrefresh(renderer->game_win);
-    wnoutrefresh(renderer->stats_win);
-    wnoutrefresh(renderer->next_win);
-    doupdate();
+    if (renderer->backend == RENDER_BACKEND_CURSES) {
+        for (int i = 0; i < RENDER_WIN_COUNT; i++) {
+            wnoutrefresh(renderer->windows[i]);
+        }
+        doupdate();
+        return;
+    }
+
+    AnsiScreen* screen = &renderer->screen;
+    size_t pending = screen->out_len;
+    ansi_screen_flush(screen);
+    metrics_add(METRIC_RENDER_FRAMES, 1);
+    metrics_add(METRIC_RENDER_BYTES, screen->out_len - pending);
+    metrics_observe(METRIC_HIST_RENDER_BYTES, screen->out_len - pending);
+    if (renderer->output_fd < 0) {
+        return;
+    }
+
+    size_t sent = 0;
+    while (sent < screen->out_len) {
+        ssize_t n = write(renderer->output_fd, screen->out + sent, screen->out_len - sent);
+        if (n <= 0) {
+            break;  /* Terminal gone: drop the frame */
+        }
+        sent += (size_t)n;
+    }
+    ansi_screen_consume(screen, screen->out_len);
 }
 
-/* Cleanup ncurses */
+/* Cleanup ncurses (or restore the ANSI backend's terminal) */
 void render_cleanup(Renderer* renderer) {
-    if (renderer->game_win) {
-        delwin(renderer->game_win);
-        renderer->game_win = NULL;
-    }
-    if (renderer->stats_win) {
-        delwin(renderer->stats_win);
-        renderer->stats_win = NULL;
+    if (renderer->backend == RENDER_BACKEND_ANSI) {
+        static const char leave[] = "\033[0m\033[?25h\033[?1049l";
+        AnsiScreen* screen = &renderer->screen;
+
+        if (renderer->output_fd >= 0) {
+            ansi_screen_emit(screen, leave, sizeof(leave) - 1);
+            if (write(renderer->output_fd, screen->out, screen->out_len) < 0) {
+                /* Terminal already gone: nothing to restore */
+            }
+        }
+        ansi_screen_destroy(screen);
+        return;
     }
-    if (renderer->next_win) {
-        delwin(renderer->next_win);
-        renderer->next_win = NULL;
+
+    for (int i = 0; i < RENDER_WIN_COUNT; i++) {
+        if (renderer->windows[i]) {
+            delwin(renderer->windows[i]);
+            renderer->windows[i] = NULL;
+        }
     }
     endwin();
 }
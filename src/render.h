@@ -2,28 +2,115 @@
 #define RENDER_H
 
 #include <ncurses.h>
+#include <stddef.h>
+#include "ansi.h"
 #include "game.h"
+#include "framestats.h"
+#include "scores.h"
 
-/* Renderer state structure */
+/* Output backend */
+typedef enum {
+    RENDER_BACKEND_CURSES,  /* ncurses windows on the controlling terminal */
+    RENDER_BACKEND_ANSI     /* Raw escape sequences from a virtual screen */
+} RenderBackend;
+
+/* Panels of the layout */
+typedef enum {
+    RENDER_WIN_GAME,   /* Main game board */
+    RENDER_WIN_STATS,  /* Stats panel (score, level, lines) */
+    RENDER_WIN_NEXT,   /* Next piece preview (inside the stats panel) */
+    RENDER_WIN_COUNT
+} RenderWindow;
+
+/* Screen position and size of a panel (border included) */
+typedef struct {
+    int top;
+    int left;
+    int height;
+    int width;
+} RenderRect;
+
+/* Renderer state structure
+ * The renderer remembers what it last drew (board cells, stats values,
+ * preview piece, overlays) and only emits what changed; a frame in which
+ * nothing changed draws nothing. Both backends draw the same layout
+ * through the same calls. */
 typedef struct {
-    WINDOW* game_win;   /* Main game board window */
-    WINDOW* stats_win;  /* Stats panel (score, level, lines) */
-    WINDOW* next_win;   /* Next piece preview window */
-    int color_pairs[8]; /* Background + 7 piece colors */
+    RenderBackend backend;
+    RenderRect rects[RENDER_WIN_COUNT];
+    WINDOW* windows[RENDER_WIN_COUNT];  /* Curses backend */
+    int color_pairs[BOARD_GARBAGE_COLOR + 1]; /* Background + 7 piece colors + garbage */
+
+    /* ANSI backend */
+    AnsiScreen screen;
+    int output_fd;  /* Frames are written here; -1 = kept for the caller */
+
+    /* Last drawn frame (reset by render_clear) */
+    uint8_t drawn_cells[BOARD_HEIGHT][BOARD_WIDTH];  /* Encoded cell contents */
+    int drawn_score;
+    int drawn_high_score;
+    int drawn_level;
+    int drawn_lines;
+    int drawn_next;       /* Pieces in preview window (3 bits each), -1 = none */
+    bool labels_drawn;    /* Static stats labels present */
+    bool overlay_drawn;   /* Start screen / pause / game over text present */
+    int scene;            /* Scene key of last frame, -1 = none */
+
+    /* Frame timing panel (--debug-stats) */
+    bool debug_panel;         /* Compact stats layout with timing panel */
+    uint64_t drawn_debug_epoch;  /* Refresh count / interval last drawn */
+
+    /* Persistent leaderboards for the game over screen, NULL = none */
+    const ScoreTable* scores;
+    int selected_level;  /* Starting level, from render_begin_frame */
 } Renderer;
 
 /* Initialize ncurses and create windows */
 void render_init(Renderer* renderer);
 
-/* Clear screen */
+/* Initialize the ANSI backend (no ncurses): each render_refresh turns the
+ * frame's changes into escape sequences with run-length color changes
+ * and coalesced cursor moves. With output_fd >= 0 they are sent with a
+ * single write() per frame (the terminal's alternate screen is used);
+ * with -1 they stay buffered for render_get_output and the caller sets
+ * up and restores the remote terminal. rows / cols <= 0 query the size
+ * of output_fd.
+ * Returns false if out of memory */
+bool render_init_ansi(Renderer* renderer, int output_fd, int rows, int cols);
+
+/* Bytes produced by the ANSI backend without an output descriptor */
+const char* render_get_output(const Renderer* renderer, size_t* length);
+
+/* Drop the first length output bytes (after sending them elsewhere) */
+void render_consume_output(Renderer* renderer, size_t length);
+
+/* Clear screen and forget the last drawn frame (next frame redraws fully) */
 void render_clear(Renderer* renderer);
 
+/* Begin a frame: clears only when the scene (game state, or selected
+ * level on the start screen) differs from the previous frame */
+void render_begin_frame(Renderer* renderer, const Game* game, int selected_level);
+
 /* Draw entire game board with current piece */
 void render_draw_game(Renderer* renderer, const Game* game);
 
 /* Draw UI panels (score, level, lines, next piece preview) */
 void render_draw_stats(Renderer* renderer, const Game* game);
 
+/* Enable the frame timing panel: stats switch to a compact layout to
+ * make room for it in the stats window (call before drawing) */
+void render_set_debug_panel(Renderer* renderer, bool enabled);
+
+/* Draw frame timing panel (mean and max microseconds per phase)
+ * Redrawn only every half second of rendered frames, so the panel itself
+ * adds little terminal output */
+void render_draw_debug(Renderer* renderer, const FrameStats* stats);
+
+/* Show the player's best and rank for the game's starting level on the
+ * game over screen. The table is only read while drawing that overlay,
+ * so a game's score must be submitted before its game over frame */
+void render_set_scores(Renderer* renderer, const ScoreTable* scores);
+
 /* Draw start screen with level selection */
 void render_draw_start_screen(Renderer* renderer, int selected_level);
 
@@ -36,7 +123,7 @@ void render_draw_game_over(Renderer* renderer, const Game* game);
 /* Refresh display (call once per frame) */
 void render_refresh(Renderer* renderer);
 
-/* Cleanup ncurses */
+/* Cleanup ncurses (or restore the terminal the ANSI backend drew to) */
 void render_cleanup(Renderer* renderer);
 
 #endif /* RENDER_H */
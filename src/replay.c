@@ -0,0 +1,208 @@
+#include "replay.h"
+#include <string.h>
+
+#define REPLAY_MAGIC "NTRP"
+#define REPLAY_END_FRAME 0xFFFFFFFFu  /* Frame tag of the trailer record */
+
+/* Little-endian field encoding */
+static void put_u16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t* in) {
+    return (uint16_t)(in[0] | in[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t get_u64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+/* Write bytes, remembering any failure */
+static void write_bytes(ReplayWriter* writer, const uint8_t* data, size_t size) {
+    if (fwrite(data, 1, size, writer->file) != size) {
+        writer->failed = true;
+    }
+}
+
+/* Open a recording */
+bool replay_writer_open(ReplayWriter* writer, const char* path, uint64_t seed) {
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return false;
+    }
+
+    setvbuf(writer->file, writer->buffer, _IOFBF, sizeof(writer->buffer));
+    writer->seed = seed;
+    writer->started = false;
+    writer->failed = false;
+    return true;
+}
+
+/* Write header */
+void replay_write_start(ReplayWriter* writer, int level) {
+    uint8_t header[16];
+
+    if (writer->started) {
+        return;
+    }
+
+    memcpy(header, REPLAY_MAGIC, 4);
+    put_u16(header + 4, REPLAY_VERSION);
+    put_u16(header + 6, (uint16_t)level);
+    put_u64(header + 8, writer->seed);
+    write_bytes(writer, header, sizeof(header));
+    writer->started = true;
+}
+
+/* Record one input */
+void replay_write_input(ReplayWriter* writer, uint32_t frame, InputAction action) {
+    uint8_t record[5];
+
+    if (!writer->started) {
+        return;
+    }
+
+    put_u32(record, frame);
+    record[4] = (uint8_t)action;
+    write_bytes(writer, record, sizeof(record));
+}
+
+/* Write trailer and close */
+bool replay_writer_close(ReplayWriter* writer, const Game* game) {
+    if (writer->started) {
+        uint8_t trailer[17];
+        put_u32(trailer, REPLAY_END_FRAME);
+        trailer[4] = 0;
+        put_u32(trailer + 5, game->frame_count);
+        put_u32(trailer + 9, (uint32_t)game->score);
+        put_u32(trailer + 13, (uint32_t)game->lines_cleared);
+        write_bytes(writer, trailer, sizeof(trailer));
+    }
+
+    if (fclose(writer->file) != 0) {
+        writer->failed = true;
+    }
+    writer->file = NULL;
+    return !writer->failed;
+}
+
+/* Apply an in-game input */
+void replay_apply_input(Game* game, InputAction action) {
+    switch (action) {
+        case INPUT_LEFT:
+            game_shift_press(game, -1);
+            break;
+        case INPUT_RIGHT:
+            game_shift_press(game, 1);
+            break;
+        case INPUT_DOWN:
+            game_move_down(game);
+            break;
+        case INPUT_ROTATE:
+            game_rotate(game);
+            break;
+        case INPUT_HARD_DROP:
+            game_hard_drop(game);
+            break;
+        case INPUT_PAUSE:
+            game_toggle_pause(game);
+            break;
+        case INPUT_NONE:
+        case INPUT_QUIT:
+        case INPUT_START:
+            break;
+    }
+}
+
+/* Step a game up to the given frame (stops early if it ends) */
+static void advance_to_frame(Game* game, uint32_t frame) {
+    if (frame > game->frame_count) {
+        game_step_frames(game, (int)(frame - game->frame_count));
+    }
+}
+
+/* Play a recording back */
+bool replay_play(const char* path, ReplayResult* result, GameLockHook hook, void* ctx) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    uint8_t header[16];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, REPLAY_MAGIC, 4) != 0 ||
+        get_u16(header + 4) != REPLAY_VERSION) {
+        fclose(file);
+        return false;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->starting_level = get_u16(header + 6);
+    result->seed = get_u64(header + 8);
+
+    Game game;
+    game_init_seeded(&game, result->seed);
+    game_set_lock_hook(&game, hook, ctx, true);
+    game_set_starting_level(&game, result->starting_level);
+
+    /* Apply each input on the frame it was recorded on */
+    bool complete = false;
+    uint8_t record[5];
+    while (fread(record, 1, sizeof(record), file) == sizeof(record)) {
+        uint32_t frame = get_u32(record);
+
+        if (frame == REPLAY_END_FRAME) {
+            uint8_t trailer[12];
+            if (fread(trailer, 1, sizeof(trailer), file) == sizeof(trailer)) {
+                result->expected_frames = get_u32(trailer);
+                result->expected_score = (int)get_u32(trailer + 4);
+                result->expected_lines = (int)get_u32(trailer + 8);
+                advance_to_frame(&game, result->expected_frames);
+                complete = true;
+            }
+            break;
+        }
+
+        advance_to_frame(&game, frame);
+        replay_apply_input(&game, (InputAction)record[4]);
+        result->inputs++;
+    }
+    fclose(file);
+
+    result->frames = game.frame_count;
+    result->score = game.score;
+    result->lines = game.lines_cleared;
+    return complete;
+}
+
+/* Check playback against the recorded outcome */
+bool replay_result_matches(const ReplayResult* result) {
+    return result->frames == result->expected_frames &&
+           result->score == result->expected_score &&
+           result->lines == result->expected_lines;
+}
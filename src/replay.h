@@ -0,0 +1,118 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "game.h"
+#include "input.h"
+
+/**
+ * replay.h - Input-log recording and deterministic playback
+ *
+ * A recording is the game seed and starting level followed by every
+ * in-game InputAction tagged with the game frame (Game.frame_count) it
+ * was applied on. The game is deterministic in frames and actions, so
+ * stepping a freshly seeded game to each tagged frame and applying the
+ * action reproduces the session exactly, with no real-time waiting.
+ *
+ * File layout (all integers little-endian):
+ *   header:  "NTRP", u16 version, u16 starting level, u64 seed
+ *   records: u32 frame, u8 InputAction (repeated)
+ *   trailer: u32 0xFFFFFFFF, u8 0, then u32 final frame, u32 score,
+ *            u32 lines
+ */
+
+#define REPLAY_VERSION 2  /* 2: horizontal keys drive auto-shift */
+#define REPLAY_BUFFER_SIZE 65536  /* stdio buffer for recording */
+
+/* Recording in progress */
+typedef struct {
+    FILE* file;
+    uint64_t seed;
+    bool started;   /* Header written (game left the start screen) */
+    bool failed;    /* A write failed; the recording is incomplete */
+    char buffer[REPLAY_BUFFER_SIZE];
+} ReplayWriter;
+
+/* Outcome of playing a recording back */
+typedef struct {
+    uint64_t seed;
+    int starting_level;
+    uint32_t inputs;            /* Input records applied */
+    uint32_t expected_frames;   /* From the trailer */
+    int expected_score;
+    int expected_lines;
+    uint32_t frames;            /* Reached by playback */
+    int score;
+    int lines;
+} ReplayResult;
+
+/**
+ * Open a recording for a session whose game was seeded with seed.
+ *
+ * @param writer Pointer to writer structure
+ * @param path File to create (truncated if it exists)
+ * @param seed Seed passed to game_init_seeded
+ * @return true on success, false if the file could not be created
+ */
+bool replay_writer_open(ReplayWriter* writer, const char* path, uint64_t seed);
+
+/**
+ * Write the header once the game starts at the chosen level.
+ *
+ * @param writer Pointer to open writer
+ * @param level Starting level passed to game_set_starting_level
+ */
+void replay_write_start(ReplayWriter* writer, int level);
+
+/**
+ * Record an in-game input, applied on the given game frame.
+ * Ignored until replay_write_start has been called.
+ *
+ * @param writer Pointer to open writer
+ * @param frame Game.frame_count when the action was applied
+ * @param action Action applied
+ */
+void replay_write_input(ReplayWriter* writer, uint32_t frame, InputAction action);
+
+/**
+ * Write the trailer with the final game result and close the file.
+ *
+ * @param writer Pointer to open writer
+ * @param game Game at the end of the session
+ * @return true if the whole recording was written successfully
+ */
+bool replay_writer_close(ReplayWriter* writer, const Game* game);
+
+/**
+ * Apply an in-game InputAction the same way the interactive loop does
+ * (start-screen and quit actions are ignored).
+ *
+ * @param game Pointer to game
+ * @param action Action to apply
+ */
+void replay_apply_input(Game* game, InputAction action);
+
+/**
+ * Play a recording back headless at full speed.
+ *
+ * @param path Recording to read
+ * @param result Filled with the expected and reproduced outcome
+ * @param hook Lock hook installed on the replayed game, with the pre-lock
+ *             board (NULL for none), e.g. corpus_lock_hook to turn a
+ *             session into training data
+ * @param ctx Context passed to hook
+ * @return false if the file is missing, truncated or not a recording
+ */
+bool replay_play(const char* path, ReplayResult* result, GameLockHook hook, void* ctx);
+
+/**
+ * Check whether playback reproduced the recorded outcome.
+ *
+ * @param result Result from replay_play
+ * @return true if frames, score and lines all match
+ */
+bool replay_result_matches(const ReplayResult* result);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,34 @@
+#include "rng.h"
+
+/* PCG32 LCG multiplier and (odd) stream increment */
+#define PCG_MULTIPLIER 6364136223846793005ULL
+#define PCG_INCREMENT 1442695040888963407ULL
+
+/**
+ * Seed generator (standard PCG32 seeding sequence).
+ */
+void rng_seed(Rng* rng, uint64_t seed) {
+    rng->state = 0;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+/**
+ * Get next 32-bit output (advance LCG, then permute old state).
+ */
+uint32_t rng_next(Rng* rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + PCG_INCREMENT;
+
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+/**
+ * Get value in range [0, bound).
+ */
+uint32_t rng_range(Rng* rng, uint32_t bound) {
+    return (uint32_t)(((uint64_t)rng_next(rng) * bound) >> 32);
+}
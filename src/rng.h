@@ -0,0 +1,44 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/**
+ * rng.h - Small per-instance pseudo-random number generator
+ *
+ * PCG32 (XSH-RR output, single fixed stream). The whole state is one
+ * 64-bit word, so it can live inside each Game and be copied, snapshot
+ * or replayed freely. No global state and no locking.
+ */
+
+typedef struct {
+    uint64_t state;
+} Rng;
+
+/**
+ * Seed generator. Equal seeds always produce equal sequences.
+ *
+ * @param rng Pointer to generator
+ * @param seed Any 64-bit value
+ */
+void rng_seed(Rng* rng, uint64_t seed);
+
+/**
+ * Get next 32-bit output and advance the generator.
+ *
+ * @param rng Pointer to generator
+ * @return Uniformly distributed 32-bit value
+ */
+uint32_t rng_next(Rng* rng);
+
+/**
+ * Get value in range [0, bound) using multiply-shift reduction
+ * (no division; bias is below 2^-29 for the small bounds used here).
+ *
+ * @param rng Pointer to generator
+ * @param bound Exclusive upper bound (must be > 0)
+ * @return Value in [0, bound)
+ */
+uint32_t rng_range(Rng* rng, uint32_t bound);
+
+#endif /* RNG_H */
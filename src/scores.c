@@ -0,0 +1,287 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "scores.h"
+#include "board.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SCORES_MAGIC "NTRS"
+
+/* Entries are read in place from the mapping, right after the header */
+typedef char scores_entry_layout_check[sizeof(ScoreEntry) == 32 &&
+                                       SCORES_HEADER_SIZE % sizeof(uint32_t) == 0
+                                       ? 1 : -1];
+
+/* Build the file header */
+static void make_header(uint8_t* header) {
+    uint16_t version = SCORES_VERSION;
+    uint16_t entry_size = (uint16_t)sizeof(ScoreEntry);
+
+    memset(header, 0, SCORES_HEADER_SIZE);
+    memcpy(header, SCORES_MAGIC, 4);
+    memcpy(header + 4, &version, sizeof(version));
+    memcpy(header + 6, &entry_size, sizeof(entry_size));
+
+    /* Other board sizes keep separate tables (10x20 headers keep zeros) */
+    if (BOARD_WIDTH != 10 || BOARD_HEIGHT != 20) {
+        header[8] = BOARD_WIDTH;
+        header[9] = BOARD_HEIGHT;
+    }
+}
+
+/* Forget the current mapping */
+static void unmap_table(ScoreTable* table) {
+    if (table->map != NULL) {
+        munmap(table->map, table->map_size);
+    }
+    table->map = NULL;
+    table->map_size = 0;
+    table->entries = NULL;
+    table->count = 0;
+}
+
+/* Map an open score file into the table (an empty file is an empty table)
+ * @return false if it is not a score table */
+static bool map_fd(ScoreTable* table, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+    if (st.st_size == 0) {
+        return true;
+    }
+    if (st.st_size < SCORES_HEADER_SIZE ||
+        (st.st_size - SCORES_HEADER_SIZE) % sizeof(ScoreEntry) != 0) {
+        return false;
+    }
+
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t header[SCORES_HEADER_SIZE];
+    make_header(header);
+    if (memcmp(map, header, sizeof(header)) != 0) {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    table->map = map;
+    table->map_size = (size_t)st.st_size;
+    table->entries = (const ScoreEntry*)((const uint8_t*)map + SCORES_HEADER_SIZE);
+    table->count = (table->map_size - SCORES_HEADER_SIZE) / sizeof(ScoreEntry);
+    return true;
+}
+
+/* Map the file at the table's path (missing = empty table) */
+static bool map_path(ScoreTable* table) {
+    int fd = open(table->path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+    bool ok = map_fd(table, fd);
+    close(fd);  /* The mapping keeps the file referenced */
+    return ok;
+}
+
+/* Map the table */
+bool scores_open(ScoreTable* table, const char* path, const char* user) {
+    memset(table, 0, sizeof(*table));
+    strncpy(table->user, user, SCORES_USER_SIZE - 1);
+
+    size_t length = strlen(path) + 1;
+    table->path = malloc(length);
+    if (table->path == NULL) {
+        return false;
+    }
+    memcpy(table->path, path, length);
+
+    if (!map_path(table)) {
+        free(table->path);
+        table->path = NULL;
+        return false;
+    }
+    return true;
+}
+
+/* Index of the first entry at or after a level (binary search) */
+static size_t level_start(const ScoreTable* table, int level) {
+    size_t low = 0;
+    size_t high = table->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (table->entries[mid].level < level) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* Get a level's leaderboard */
+const ScoreEntry* scores_level(const ScoreTable* table, int level, size_t* count) {
+    size_t start = level_start(table, level);
+    size_t end = start;
+    while (end < table->count && table->entries[end].level == level) {
+        end++;
+    }
+
+    *count = end - start;
+    return *count > 0 ? &table->entries[start] : NULL;
+}
+
+/* Find a user's entry for a level */
+const ScoreEntry* scores_find(const ScoreTable* table, int level, const char* user) {
+    size_t count;
+    const ScoreEntry* entries = scores_level(table, level, &count);
+    for (size_t i = 0; i < count; i++) {
+        if (strncmp(entries[i].user, user, SCORES_USER_SIZE) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Write header and iov to fd in as few calls as it takes */
+static bool write_table(int fd, struct iovec* iov, int iov_count) {
+    while (iov_count > 0) {
+        ssize_t n = writev(fd, iov, iov_count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        /* Short write: skip what went out and retry the rest */
+        size_t done = (size_t)n;
+        while (iov_count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            iov_count--;
+        }
+        if (iov_count > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+/* Record a finished game if it is the user's best at the level */
+bool scores_submit(ScoreTable* table, int level, int score, int lines) {
+    if (table->path == NULL || score <= 0) {
+        return true;
+    }
+    const ScoreEntry* best = scores_find(table, level, table->user);
+    if (best != NULL && best->score >= (uint32_t)score) {
+        return true;
+    }
+
+    /* Merge into the newest table: another player may have written since
+     * ours was mapped */
+    ScoreTable latest = *table;
+    latest.map = NULL;
+    latest.map_size = 0;
+    latest.entries = NULL;
+    latest.count = 0;
+    if (!map_path(&latest)) {
+        return false;
+    }
+
+    ScoreEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.user, table->user, SCORES_USER_SIZE);
+    entry.score = (uint32_t)score;
+    entry.lines = (uint32_t)lines;
+    entry.level = (uint16_t)level;
+    entry.time = (uint32_t)time(NULL);
+
+    /* Insertion point (after equal scores: earlier holders keep the rank)
+     * and the user's old entry, which always sorts after it */
+    size_t count;
+    const ScoreEntry* entries = scores_level(&latest, level, &count);
+    size_t start = entries != NULL ? (size_t)(entries - latest.entries)
+                                   : level_start(&latest, level);
+    size_t insert = start;
+    while (insert < start + count && latest.entries[insert].score >= entry.score) {
+        insert++;
+    }
+    const ScoreEntry* old = scores_find(&latest, level, table->user);
+    if (old != NULL && old->score >= entry.score) {
+        unmap_table(&latest);  /* Beaten meanwhile from another terminal */
+        return true;
+    }
+    size_t skip = old != NULL ? (size_t)(old - latest.entries) : latest.count;
+
+    /* Whole new table in one writev: header, entries before the new one,
+     * the new one, then the rest without the user's old entry */
+    uint8_t header[SCORES_HEADER_SIZE];
+    make_header(header);
+    ScoreEntry* base = (ScoreEntry*)latest.entries;
+    struct iovec iov[5] = {
+        {header, sizeof(header)},
+        {base, insert * sizeof(ScoreEntry)},
+        {&entry, sizeof(entry)},
+        {base + insert, (skip - insert) * sizeof(ScoreEntry)},
+        {base + skip + (old != NULL), (latest.count - skip - (old != NULL)) *
+                                      sizeof(ScoreEntry)},
+    };
+
+    /* Temporary file beside the table, so the rename stays on one file
+     * system and replaces the table in a single step. mkstemp picks a
+     * name no other writer holds, even from another host on NFS */
+    size_t tmp_length = strlen(table->path) + sizeof(".XXXXXX");
+    char* tmp_path = malloc(tmp_length);
+    if (tmp_path == NULL) {
+        unmap_table(&latest);
+        return false;
+    }
+    snprintf(tmp_path, tmp_length, "%s.XXXXXX", table->path);
+
+    int fd = mkstemp(tmp_path);
+    bool ok = fd >= 0 && fchmod(fd, 0644) == 0;
+    ok = ok && write_table(fd, iov, 5);
+    ok = ok && fsync(fd) == 0;
+    unmap_table(&latest);
+
+    /* Map what was written: readers of the table see the new scores */
+    ScoreTable written = *table;
+    written.map = NULL;
+    written.map_size = 0;
+    ok = ok && map_fd(&written, fd);
+    if (fd >= 0) {
+        close(fd);
+    }
+    ok = ok && rename(tmp_path, table->path) == 0;
+    if (!ok) {
+        unmap_table(&written);
+        if (fd >= 0) {
+            unlink(tmp_path);
+        }
+        free(tmp_path);
+        return false;
+    }
+    free(tmp_path);
+
+    unmap_table(table);
+    *table = written;
+    return true;
+}
+
+/* Unmap the table */
+void scores_close(ScoreTable* table) {
+    unmap_table(table);
+    free(table->path);
+    table->path = NULL;
+}
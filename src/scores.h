@@ -0,0 +1,103 @@
+#ifndef SCORES_H
+#define SCORES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * scores.h - Persistent high-score table
+ *
+ * Keeps each user's best score per starting level in one small file
+ * shared by every player (e.g. in a common home directory). The file is
+ * a 16-byte header followed by fixed-size ScoreEntry records sorted by
+ * starting level, then score (highest first), so it is mmapped at
+ * startup and read in place: no parsing, and a level's leaderboard is a
+ * binary search away however many entries the table holds.
+ *
+ * Only a score that beats the player's own best is written. The writer
+ * re-reads the current file, writes the new table to a temporary file
+ * next to it in a single writev, fsyncs it and renames it over the old
+ * one, so readers and crashes only ever see a complete table. Two
+ * players finishing at the same instant may race: the last rename wins.
+ * Fields are in host byte order. Tables of other board sizes than 10x20
+ * are tagged with the size and rejected by other builds.
+ */
+
+#define SCORES_VERSION 1
+#define SCORES_HEADER_SIZE 16
+#define SCORES_USER_SIZE 16  /* Including the terminating NUL */
+
+/* One user's best game at one starting level */
+typedef struct {
+    char user[SCORES_USER_SIZE];  /* NUL-terminated, truncated login name */
+    uint32_t score;
+    uint32_t lines;
+    uint16_t level;               /* Starting level (1-10) */
+    uint16_t reserved;            /* Zero */
+    uint32_t time;                /* Unix time the score was set */
+} ScoreEntry;
+
+/* Read-only mapping of the table, plus where and as whom to write */
+typedef struct {
+    const ScoreEntry* entries;
+    size_t count;
+    void* map;
+    size_t map_size;
+    char* path;
+    char user[SCORES_USER_SIZE];
+} ScoreTable;
+
+/**
+ * Map the table (a missing file is an empty table, created on the first
+ * submitted score).
+ *
+ * @param table Pointer to table structure
+ * @param path Score file
+ * @param user Player name for scores_submit (truncated to fit)
+ * @return false if the file exists but is not a score table, or memory
+ *         ran out
+ */
+bool scores_open(ScoreTable* table, const char* path, const char* user);
+
+/**
+ * Get a level's leaderboard: its entries, highest score first.
+ *
+ * @param table Pointer to open table
+ * @param level Starting level
+ * @param count Set to the number of entries (0 if none)
+ * @return First entry of the level (NULL if none)
+ */
+const ScoreEntry* scores_level(const ScoreTable* table, int level, size_t* count);
+
+/**
+ * Find a user's entry for a level.
+ *
+ * @param table Pointer to open table
+ * @param level Starting level
+ * @param user Player name
+ * @return The entry, or NULL if the user has no score at that level
+ */
+const ScoreEntry* scores_find(const ScoreTable* table, int level, const char* user);
+
+/**
+ * Record a finished game for the table's user. Does nothing unless it
+ * beats the user's best for the level; otherwise the file is rewritten
+ * as described above and the table remapped to include the new score.
+ *
+ * @param table Pointer to open table
+ * @param level Starting level of the game
+ * @param score Final score
+ * @param lines Lines cleared
+ * @return false if the new table could not be written
+ */
+bool scores_submit(ScoreTable* table, int level, int score, int lines);
+
+/**
+ * Unmap the table.
+ *
+ * @param table Pointer to open table
+ */
+void scores_close(ScoreTable* table);
+
+#endif /* SCORES_H */
@@ -0,0 +1,548 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "game.h"
+#include "input.h"
+#include "metrics.h"
+#include "render.h"
+
+/* Nanoseconds per second */
+#define NSEC_PER_SEC 1000000000L
+
+/* Most frames one tick may step (a stalled server does not fast-forward) */
+#define MAX_TICK_FRAMES GAME_FRAME_RATE
+
+/* Bytes read from a connection per wake-up */
+#define READ_CHUNK 512
+
+/* Telnet protocol bytes (RFC 854) */
+#define TELNET_IAC 255
+#define TELNET_SB 250
+#define TELNET_SE 240
+#define TELNET_WILL 251
+#define TELNET_OPT_ECHO 1
+#define TELNET_OPT_SGA 3
+
+/* Telnet command parser states */
+typedef enum {
+    TELNET_DATA,
+    TELNET_COMMAND,     /* After IAC */
+    TELNET_OPTION,      /* After IAC WILL/WONT/DO/DONT */
+    TELNET_SUBNEG,      /* Inside IAC SB ... */
+    TELNET_SUBNEG_IAC   /* IAC inside subnegotiation */
+} TelnetState;
+
+/* Sequence sent on connect: server does the echoing (so the client
+ * does not), character-at-a-time mode, hidden cursor */
+static const char SESSION_HELLO[] = {
+    (char)TELNET_IAC, (char)TELNET_WILL, TELNET_OPT_ECHO,
+    (char)TELNET_IAC, (char)TELNET_WILL, TELNET_OPT_SGA,
+    '\033', '[', '?', '2', '5', 'l'
+};
+
+/* Sequence sent before closing: reset colors, clear, show cursor */
+static const char SESSION_BYE[] = "\033[0m\033[2J\033[H\033[?25h";
+
+/* One connected player */
+typedef struct {
+    int fd;
+    bool closing;  /* Flush what is buffered, then disconnect */
+    Game game;
+    int selected_level;
+    MetricsPieceClock piece_clock;  /* Input-to-lock timing (metrics) */
+
+    /* Input parsing */
+    TelnetState telnet;
+    InputDecoder keys;
+
+    /* Output not yet accepted by the socket */
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+    bool out_failed;  /* Peer gone or out of memory: drop the session */
+
+    /* Screen (ANSI backend, output collected into out) */
+    Renderer renderer;
+    bool greeted;  /* Telnet options and cursor setup sent */
+} Session;
+
+typedef struct {
+    int listen_fd;
+    int tick_fd;
+    bool tick_armed;
+    uint64_t seed_base;
+    uint64_t serial;  /* Sessions accepted so far (seeds differ per session) */
+
+    Session** sessions;
+    size_t count;
+    size_t capacity;
+    struct pollfd* fds;  /* Listener, tick, then one per session */
+} Server;
+
+/* Set from the signal handler to end server_run */
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signum) {
+    (void)signum;
+    stop_requested = 1;
+}
+
+/* ---- Output buffer ---- */
+
+static void out_append(Session* session, const char* bytes, size_t length) {
+    if (session->out_len + length > session->out_cap) {
+        size_t capacity = session->out_cap > 0 ? session->out_cap : 1024;
+        while (capacity < session->out_len + length) {
+            capacity *= 2;
+        }
+        char* grown = realloc(session->out, capacity);
+        if (grown == NULL) {
+            session->out_failed = true;
+            return;
+        }
+        session->out = grown;
+        session->out_cap = capacity;
+    }
+
+    memcpy(session->out + session->out_len, bytes, length);
+    session->out_len += length;
+}
+
+/* Write as much buffered output as the socket accepts */
+static void session_flush(Session* session) {
+    size_t sent = 0;
+    while (sent < session->out_len) {
+        ssize_t n = send(session->fd, session->out + sent, session->out_len - sent,
+                         MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                session->out_failed = true;  /* Peer gone */
+            }
+            break;
+        }
+    }
+
+    memmove(session->out, session->out + sent, session->out_len - sent);
+    session->out_len -= sent;
+}
+
+/* ---- Drawing ---- */
+
+/* Bring the client's screen up to date with its game (same frame
+ * sequence as the local game loop) */
+static void session_draw(Session* session) {
+    Renderer* renderer = &session->renderer;
+    const Game* game = &session->game;
+
+    if (!session->greeted) {
+        out_append(session, SESSION_HELLO, sizeof(SESSION_HELLO));
+        session->greeted = true;
+    }
+
+    render_begin_frame(renderer, game, session->selected_level);
+    if (game->state == GAME_STATE_START_SCREEN) {
+        render_draw_start_screen(renderer, session->selected_level);
+    } else {
+        render_draw_game(renderer, game);
+        render_draw_stats(renderer, game);
+        if (game_is_paused(game)) {
+            render_draw_pause(renderer);
+        }
+        if (game_is_over(game)) {
+            render_draw_game_over(renderer, game);
+        }
+    }
+    render_refresh(renderer);
+
+    size_t length;
+    const char* bytes = render_get_output(renderer, &length);
+    out_append(session, bytes, length);
+    render_consume_output(renderer, length);
+}
+
+/* ---- Input ---- */
+
+/* Apply one key to a session (same controls as the local game) */
+static void session_handle_input(Session* session, InputAction action) {
+    Game* game = &session->game;
+    bool start_screen = game->state == GAME_STATE_START_SCREEN;
+    int* level = &session->selected_level;
+
+    if (game->state == GAME_STATE_PLAYING && action != INPUT_NONE &&
+        action != INPUT_QUIT && action != INPUT_START && action != INPUT_PAUSE) {
+        metrics_note_input(&session->piece_clock);
+    }
+
+    switch (action) {
+        case INPUT_LEFT:
+            if (start_screen) {
+                *level = *level == 1 ? 10 : *level - 1;
+            } else {
+                game_shift_press(game, -1);
+            }
+            break;
+        case INPUT_RIGHT:
+            if (start_screen) {
+                *level = *level == 10 ? 1 : *level + 1;
+            } else {
+                game_shift_press(game, 1);
+            }
+            break;
+        case INPUT_DOWN:
+        case INPUT_ROTATE:
+            if (start_screen) {
+                *level = (*level + 4) % 10 + 1;  /* Other row of the grid */
+            } else if (action == INPUT_DOWN) {
+                game_move_down(game);
+            } else {
+                game_rotate(game);
+            }
+            break;
+        case INPUT_HARD_DROP:
+            if (!start_screen) {
+                game_hard_drop(game);
+            }
+            break;
+        case INPUT_PAUSE:
+            if (!start_screen) {
+                game_toggle_pause(game);
+            }
+            break;
+        case INPUT_QUIT:
+            out_append(session, SESSION_BYE, sizeof(SESSION_BYE) - 1);
+            session->closing = true;
+            break;
+        case INPUT_START:
+            if (start_screen) {
+                game_set_starting_level(game, *level);
+            }
+            break;
+        case INPUT_NONE:
+            break;
+    }
+}
+
+/* Strip telnet commands from received bytes in place
+ * @return Number of data bytes left */
+static size_t strip_telnet(Session* session, unsigned char* bytes, size_t length) {
+    size_t kept = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        unsigned char byte = bytes[i];
+        switch (session->telnet) {
+            case TELNET_DATA:
+                if (byte == TELNET_IAC) {
+                    session->telnet = TELNET_COMMAND;
+                } else {
+                    bytes[kept++] = byte;
+                }
+                break;
+            case TELNET_COMMAND:
+                if (byte == TELNET_IAC) {
+                    bytes[kept++] = byte;  /* Escaped 255 */
+                    session->telnet = TELNET_DATA;
+                } else if (byte == TELNET_SB) {
+                    session->telnet = TELNET_SUBNEG;
+                } else if (byte >= TELNET_WILL) {
+                    session->telnet = TELNET_OPTION;
+                } else {
+                    session->telnet = TELNET_DATA;
+                }
+                break;
+            case TELNET_OPTION:
+                session->telnet = TELNET_DATA;
+                break;
+            case TELNET_SUBNEG:
+                if (byte == TELNET_IAC) {
+                    session->telnet = TELNET_SUBNEG_IAC;
+                }
+                break;
+            case TELNET_SUBNEG_IAC:
+                session->telnet = byte == TELNET_SE ? TELNET_DATA : TELNET_SUBNEG;
+                break;
+        }
+    }
+
+    return kept;
+}
+
+/* Read and apply everything the client sent */
+static void session_read(Session* session) {
+    for (;;) {
+        unsigned char bytes[READ_CHUNK];
+        ssize_t n = recv(session->fd, bytes, sizeof(bytes), 0);
+        if (n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN &&
+                       errno != EWOULDBLOCK)) {
+            session->out_failed = true;  /* Hung up */
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;  /* Drained */
+        }
+
+        size_t length = strip_telnet(session, bytes, (size_t)n);
+        InputAction actions[READ_CHUNK];
+        int count = input_decode(&session->keys, bytes, length, actions, READ_CHUNK);
+        for (int i = 0; i < count && !session->closing; i++) {
+            session_handle_input(session, actions[i]);
+        }
+    }
+}
+
+/* ---- Session list ---- */
+
+static bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void session_destroy(Session* session) {
+    render_cleanup(&session->renderer);
+    close(session->fd);
+    free(session->out);
+    free(session);
+}
+
+/* Accept every pending connection */
+static void server_accept(Server* server) {
+    for (;;) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        if (server->count >= SERVER_MAX_SESSIONS || !set_nonblocking(fd)) {
+            close(fd);
+            continue;
+        }
+
+        if (server->count == server->capacity) {
+            size_t capacity = server->capacity > 0 ? server->capacity * 2 : 16;
+            Session** sessions = realloc(server->sessions, capacity * sizeof(*sessions));
+            struct pollfd* fds = realloc(server->fds, (capacity + 2) * sizeof(*fds));
+            if (sessions != NULL) {
+                server->sessions = sessions;
+            }
+            if (fds != NULL) {
+                server->fds = fds;
+            }
+            if (sessions == NULL || fds == NULL) {
+                close(fd);
+                continue;
+            }
+            server->capacity = capacity;
+        }
+
+        Session* session = calloc(1, sizeof(*session));
+        if (session == NULL || !render_init_ansi(&session->renderer, -1,
+                                                 SERVER_SCREEN_ROWS, SERVER_SCREEN_COLS)) {
+            free(session);
+            close(fd);
+            continue;
+        }
+        session->fd = fd;
+        session->selected_level = 1;
+        session->telnet = TELNET_DATA;
+        input_decoder_init(&session->keys);
+        game_init_seeded(&session->game, server->seed_base +
+                         server->serial++ * 0x9E3779B97F4A7C15ULL);
+        if (metrics_exporting()) {
+            game_set_lock_hook(&session->game, metrics_lock_hook, &session->piece_clock,
+                               false);
+        }
+        server->sessions[server->count++] = session;
+    }
+}
+
+/* Drop sessions that quit (once their output is flushed) or failed */
+static void server_reap(Server* server) {
+    size_t i = 0;
+    while (i < server->count) {
+        Session* session = server->sessions[i];
+        if (session->out_failed || (session->closing && session->out_len == 0)) {
+            session_destroy(session);
+            server->sessions[i] = server->sessions[--server->count];
+        } else {
+            i++;
+        }
+    }
+}
+
+/* ---- Main loop ---- */
+
+/* Start or stop the shared 60 Hz tick */
+static void set_tick(Server* server, bool armed) {
+    if (armed == server->tick_armed) {
+        return;
+    }
+
+    struct itimerspec spec = {{0, 0}, {0, 0}};
+    if (armed) {
+        spec.it_interval.tv_nsec = NSEC_PER_SEC / GAME_FRAME_RATE;
+        spec.it_value = spec.it_interval;
+    }
+    timerfd_settime(server->tick_fd, 0, &spec, NULL);
+    server->tick_armed = armed;
+}
+
+/* Step every playing session by the frames that elapsed */
+static void server_tick(Server* server) {
+    uint64_t expirations = 0;
+    if (read(server->tick_fd, &expirations, sizeof(expirations)) <= 0) {
+        return;
+    }
+
+    /* More than one expiration: the loop missed ticks by that much */
+    metrics_add(METRIC_FRAMES, expirations);
+    if (expirations > 1) {
+        metrics_add(METRIC_FRAME_OVERRUNS, expirations - 1);
+        metrics_observe(METRIC_HIST_FRAME_OVERRUN,
+                        (expirations - 1) * (uint64_t)(1000000 / GAME_FRAME_RATE));
+    }
+
+    int frames = expirations < MAX_TICK_FRAMES ? (int)expirations : MAX_TICK_FRAMES;
+    for (size_t i = 0; i < server->count; i++) {
+        Game* game = &server->sessions[i]->game;
+        if (game->state == GAME_STATE_PLAYING) {
+            game_update(game, frames);
+        }
+    }
+}
+
+static int open_listener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)port);
+
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0 || !set_nonblocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Serve sessions until a stop signal arrives */
+bool server_run(int port) {
+    Server server;
+    memset(&server, 0, sizeof(server));
+    server.seed_base = (uint64_t)time(NULL);
+
+    server.listen_fd = open_listener(port);
+    if (server.listen_fd < 0) {
+        return false;
+    }
+    server.tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    server.fds = malloc(2 * sizeof(*server.fds));
+    if (server.tick_fd < 0 || server.fds == NULL) {
+        close(server.listen_fd);
+        if (server.tick_fd >= 0) {
+            close(server.tick_fd);
+        }
+        free(server.fds);
+        return false;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    while (!stop_requested) {
+        /* WAIT PHASE: tick only while someone is playing */
+        bool playing = false;
+        for (size_t i = 0; i < server.count && !playing; i++) {
+            playing = server.sessions[i]->game.state == GAME_STATE_PLAYING;
+        }
+        set_tick(&server, playing);
+
+        server.fds[0].fd = server.listen_fd;
+        server.fds[0].events = POLLIN;
+        server.fds[1].fd = server.tick_fd;
+        server.fds[1].events = POLLIN;
+        for (size_t i = 0; i < server.count; i++) {
+            server.fds[i + 2].fd = server.sessions[i]->fd;
+            server.fds[i + 2].events = POLLIN |
+                                       (server.sessions[i]->out_len > 0 ? POLLOUT : 0);
+        }
+        size_t polled = server.count;
+        if (poll(server.fds, polled + 2, -1) < 0) {
+            continue;  /* Interrupted (stop signal is checked above) */
+        }
+
+        /* UPDATE PHASE: one pass over all playing sessions */
+        if (server.fds[1].revents & POLLIN) {
+            server_tick(&server);
+        }
+
+        /* INPUT PHASE: keys act on the state they were pressed in */
+        for (size_t i = 0; i < polled; i++) {
+            if (server.fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+                session_read(server.sessions[i]);
+            }
+        }
+        if (server.fds[0].revents & POLLIN) {
+            server_accept(&server);
+        }
+
+        /* RENDER PHASE: draw into empty buffers, then flush */
+        for (size_t i = 0; i < server.count; i++) {
+            Session* session = server.sessions[i];
+            if (session->out_len == 0 && !session->closing) {
+                session_draw(session);
+            }
+            if (session->out_len > 0) {
+                session_flush(session);
+            }
+        }
+        server_reap(&server);
+    }
+
+    /* Say goodbye to everyone still connected */
+    for (size_t i = 0; i < server.count; i++) {
+        Session* session = server.sessions[i];
+        out_append(session, SESSION_BYE, sizeof(SESSION_BYE) - 1);
+        session_flush(session);
+        session_destroy(session);
+    }
+    free(server.sessions);
+    free(server.fds);
+    close(server.tick_fd);
+    close(server.listen_fd);
+    return true;
+}
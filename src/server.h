@@ -0,0 +1,43 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdbool.h>
+
+/**
+ * server.h - Multi-session game server
+ *
+ * Hosts many players in one process instead of one ntris process (and
+ * one ncurses screen) per player. Every TCP connection - a telnet client,
+ * or a raw byte stream such as nc or an SSH ForceCommand relay - gets its
+ * own Game and its own output buffer, and a single poll() loop serves all
+ * of them:
+ *
+ * - One shared 60 Hz timerfd tick steps every playing session in one
+ *   pass; with nobody playing the tick is disarmed and the server sleeps
+ *   until a connection or key arrives.
+ * - After each wake-up, every session's frame is drawn through its own
+ *   Renderer on the ANSI backend, whose diffed escape sequences are
+ *   appended to the session's buffer and flushed with non-blocking
+ *   writes. A session is only drawn once its previous output has been
+ *   accepted by the socket, so a slow link never stalls the loop; it
+ *   just receives fewer, larger diffs.
+ *
+ * Sessions are laid out for an 80x24 terminal.
+ */
+
+/* Connections beyond this are refused */
+#define SERVER_MAX_SESSIONS 1024
+
+/* Terminal size every session is laid out for */
+#define SERVER_SCREEN_ROWS 24
+#define SERVER_SCREEN_COLS 80
+
+/**
+ * Listen on a TCP port and serve sessions until SIGINT or SIGTERM.
+ *
+ * @param port TCP port to listen on (all IPv4 addresses)
+ * @return true on clean shutdown, false if the port could not be opened
+ */
+bool server_run(int port);
+
+#endif /* SERVER_H */
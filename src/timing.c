@@ -29,13 +29,29 @@ void timer_init(Timer* timer, int target_fps) {
 
     timer->target_frame_duration = 1.0 / (double)target_fps;
     timer->last_frame_time = timer_get_time();
+    timer->frame_accumulator = 0.0;
+    timer->fixed_step = false;
+}
+
+/**
+ * Initialize timer in fixed-step mode (no clock reads, no sleeping).
+ */
+void timer_init_fixed(Timer* timer, int target_fps) {
+    if (timer == NULL || target_fps <= 0) {
+        return;
+    }
+
+    timer->target_frame_duration = 1.0 / (double)target_fps;
+    timer->last_frame_time = 0.0;
+    timer->frame_accumulator = 0.0;
+    timer->fixed_step = true;
 }
 
 /**
  * Start a new frame (mark frame start time).
  */
 void timer_start_frame(Timer* timer) {
-    if (timer == NULL) {
+    if (timer == NULL || timer->fixed_step) {
         return;
     }
 
@@ -51,6 +67,11 @@ double timer_get_delta(const Timer* timer) {
         return 0.0;
     }
 
+    /* Fixed-step frames always last exactly one target frame */
+    if (timer->fixed_step) {
+        return timer->target_frame_duration;
+    }
+
     double current_time = timer_get_time();
     double delta = current_time - timer->last_frame_time;
 
@@ -62,13 +83,43 @@ double timer_get_delta(const Timer* timer) {
     return delta;
 }
 
+/**
+ * Get time elapsed since the frame started (uncapped).
+ */
+double timer_get_elapsed(const Timer* timer) {
+    if (timer == NULL) {
+        return 0.0;
+    }
+
+    if (timer->fixed_step) {
+        return timer->target_frame_duration;
+    }
+
+    return timer_get_time() - timer->last_frame_time;
+}
+
+/**
+ * Convert elapsed time into whole game frames (remainder carries over).
+ */
+int timer_consume_frames(Timer* timer, double delta) {
+    if (timer == NULL) {
+        return 0;
+    }
+
+    timer->frame_accumulator += delta;
+    int frames = (int)(timer->frame_accumulator / timer->target_frame_duration);
+    timer->frame_accumulator -= (double)frames * timer->target_frame_duration;
+
+    return frames;
+}
+
 /**
  * Wait for frame to complete.
  * Sleeps for the remaining frame time to maintain target FPS.
  */
-void timer_wait_frame(Timer* timer) {
-    if (timer == NULL) {
-        return;
+double timer_wait_frame(Timer* timer) {
+    if (timer == NULL || timer->fixed_step) {
+        return 0.0;
     }
 
     double current_time = timer_get_time();
@@ -81,5 +132,10 @@ void timer_wait_frame(Timer* timer) {
         sleep_spec.tv_nsec = (long)((sleep_time - (double)sleep_spec.tv_sec) * NSEC_PER_SEC);
 
         nanosleep(&sleep_spec, NULL);
+
+        /* Compare the actual wake-up with the deadline */
+        return timer_get_time() - (current_time + sleep_time);
     }
+
+    return 0.0;
 }
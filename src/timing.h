@@ -6,11 +6,19 @@
  *
  * Provides frame-based timing with delta time calculation and
  * frame rate limiting. Uses CLOCK_MONOTONIC for precise timing.
+ *
+ * A timer can also run in fixed-step mode, where every frame is exactly
+ * one target frame long: no clock reads and no sleeping, so the loop runs
+ * as fast as the CPU allows while stepping the game identically.
  */
 
+#include <stdbool.h>
+
 typedef struct {
     double last_frame_time;
     double target_frame_duration;
+    double frame_accumulator;  /* Elapsed time not yet consumed as whole frames */
+    bool fixed_step;           /* Fixed-step mode (no clock, no sleep) */
 } Timer;
 
 /**
@@ -21,6 +29,15 @@ typedef struct {
  */
 void timer_init(Timer* timer, int target_fps);
 
+/**
+ * Initialize timer in fixed-step mode: each frame lasts exactly
+ * 1 / target_fps seconds and timer_wait_frame never sleeps.
+ *
+ * @param timer Pointer to timer structure
+ * @param target_fps Frame rate the game is stepped at (typically 60)
+ */
+void timer_init_fixed(Timer* timer, int target_fps);
+
 /**
  * Start a new frame (call at beginning of game loop).
  * Records the current time for delta calculation.
@@ -37,13 +54,35 @@ void timer_start_frame(Timer* timer);
  */
 double timer_get_delta(const Timer* timer);
 
+/**
+ * Get time elapsed since the frame started, without the delta cap.
+ * Used by loops that sleep for longer than one frame on purpose.
+ *
+ * @param timer Pointer to timer structure
+ * @return Elapsed time in seconds
+ */
+double timer_get_elapsed(const Timer* timer);
+
+/**
+ * Convert elapsed time into whole game frames.
+ * Adds delta to the timer's accumulator and returns how many whole
+ * target frames it now holds; the remainder carries over to next call.
+ *
+ * @param timer Pointer to timer structure
+ * @param delta Elapsed time in seconds (from timer_get_delta)
+ * @return Number of whole frames to step the game by
+ */
+int timer_consume_frames(Timer* timer, double delta);
+
 /**
  * Wait for frame to complete.
  * Sleeps for the remaining frame time to maintain target FPS.
  *
  * @param timer Pointer to timer structure
+ * @return Wake-up error against the frame deadline in seconds (positive =
+ *         overslept, negative = woke early), 0 if no sleep was needed
  */
-void timer_wait_frame(Timer* timer);
+double timer_wait_frame(Timer* timer);
 
 /**
  * Get current monotonic time in seconds.
@@ -0,0 +1,63 @@
+/**
+ * gen_piece_tables.c - Build-time generator for src/piece_tables.h
+ *
+ * Reads the tetromino shape tables through piece_get_shape (piece.c is
+ * the single source of truth) and prints the derived PieceInfo table:
+ * row bitmasks, lowest filled cell per column and bounding box for every
+ * (PieceType, RotationState). Run by the Makefile; output goes to stdout.
+ */
+
+#include <stdio.h>
+#include "piece.h"
+
+static const char* const TYPE_NAMES[PIECE_COUNT] = {
+    "I", "O", "T", "S", "Z", "J", "L"
+};
+
+/* Print one PieceInfo initializer derived from a shape */
+static void emit_info(const PieceShape* shape, int last) {
+    unsigned rows[4] = {0, 0, 0, 0};
+    int bottom[4] = {-1, -1, -1, -1};
+    int min_x = 3, max_x = 0, min_y = 3, max_y = 0;
+
+    for (int i = 0; i < 4; i++) {
+        int x = shape->cells[i][0];
+        int y = shape->cells[i][1];
+
+        rows[y] |= 1u << x;
+        if (y > bottom[x]) {
+            bottom[x] = y;
+        }
+        if (x < min_x) min_x = x;
+        if (x > max_x) max_x = x;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+
+    printf("        {{0x%X, 0x%X, 0x%X, 0x%X}, {%2d, %2d, %2d, %2d}, %d, %d, %d, %d}%s\n",
+           rows[0], rows[1], rows[2], rows[3],
+           bottom[0], bottom[1], bottom[2], bottom[3],
+           min_x, max_x, min_y, max_y, last ? "" : ",");
+}
+
+int main(void) {
+    printf("/* Generated by tools/gen_piece_tables from src/piece.c - do not edit */\n");
+    printf("#ifndef PIECE_TABLES_H\n");
+    printf("#define PIECE_TABLES_H\n\n");
+    printf("#include \"piece.h\"\n\n");
+    printf("/* {rows}, {bottom}, min_x, max_x, min_y, max_y */\n");
+    printf("static const PieceInfo PIECE_INFO[PIECE_COUNT][4] = {\n");
+
+    for (int type = 0; type < PIECE_COUNT; type++) {
+        printf("    /* %s-piece */\n    {\n", TYPE_NAMES[type]);
+        for (int rotation = ROT_0; rotation <= ROT_270; rotation++) {
+            emit_info(piece_get_shape((PieceType)type, (RotationState)rotation),
+                      rotation == ROT_270);
+        }
+        printf("    }%s\n", type == PIECE_COUNT - 1 ? "" : ",");
+    }
+
+    printf("};\n\n");
+    printf("#endif /* PIECE_TABLES_H */\n");
+    return 0;
+}